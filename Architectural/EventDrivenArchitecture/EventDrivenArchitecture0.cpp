@@ -1,40 +1,198 @@
 #include <iostream>
 #include <functional>
 #include <unordered_map>
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <random>
 
 
+// Returned by subscribe and used to unsubscribe. A token whose listener was
+// already removed is stale: its generation no longer matches the slot's.
+// A default SubscriptionToken{} names event 0, slot 0 with generation 0,
+// which no listener slot ever holds, so unsubscribing it returns false.
+struct SubscriptionToken {
+    uint32_t event = 0;
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+};
+
 // Event Manager
 class EventManager {
 private:
-    std::unordered_map<std::string, std::vector<std::function<void()>>> eventListeners;
+    struct Listener {
+        std::function<void()> callback;
+        uint32_t slot;
+        bool live;
+    };
+
+    struct Slot {
+        uint32_t index;      // position in listeners while subscribed
+        uint32_t generation; // bumped on every unsubscribe, never 0
+    };
+
+    // Listeners of one event in a dense array, addressed through a slot map
+    // so a token finds its listener in O(1) and removal is a swap with the
+    // last element. Changes made while the event is being published are
+    // applied once the outermost publish returns.
+    struct EventListeners {
+        std::vector<Listener> listeners;
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlots;
+        std::vector<Listener> pendingAdds;
+        std::vector<uint32_t> pendingRemovals;
+        int publishing = 0;
+    };
+
+    std::unordered_map<std::string, uint32_t> eventIds;
+    std::deque<EventListeners> events; // a deque keeps an event in place while a listener subscribes to a new one
+
+    uint32_t eventId(const std::string& eventName) {
+        auto [it, inserted] = eventIds.try_emplace(eventName, static_cast<uint32_t>(events.size()));
+        if (inserted) {
+            events.emplace_back();
+        }
+        return it->second;
+    }
+
+    static void removeListener(EventListeners& event, uint32_t slot) {
+        uint32_t index = event.slots[slot].index;
+        if (index != static_cast<uint32_t>(event.listeners.size()) - 1) {
+            event.listeners[index] = std::move(event.listeners.back());
+            event.slots[event.listeners[index].slot].index = index;
+        }
+        event.listeners.pop_back();
+        event.freeSlots.push_back(slot);
+    }
+
+    static void applyPending(EventListeners& event) {
+        for (uint32_t slot : event.pendingRemovals) {
+            removeListener(event, slot);
+        }
+        event.pendingRemovals.clear();
+        for (auto& listener : event.pendingAdds) {
+            if (listener.live) {
+                event.slots[listener.slot].index = static_cast<uint32_t>(event.listeners.size());
+                event.listeners.push_back(std::move(listener));
+            }
+        }
+        event.pendingAdds.clear();
+    }
 
 public:
-    void subscribe(const std::string& eventName, std::function<void()> eventListener) {
-        eventListeners[eventName].push_back(eventListener);
+    SubscriptionToken subscribe(const std::string& eventName, std::function<void()> eventListener) {
+        uint32_t id = eventId(eventName);
+        EventListeners& event = events[id];
+        uint32_t slot;
+        if (!event.freeSlots.empty()) {
+            slot = event.freeSlots.back();
+            event.freeSlots.pop_back();
+        }
+        else {
+            slot = static_cast<uint32_t>(event.slots.size());
+            event.slots.push_back(Slot{ 0, 1 });
+        }
+        Listener listener{ std::move(eventListener), slot, true };
+        if (event.publishing > 0) {
+            // Appending now could move the listener that is running
+            event.pendingAdds.push_back(std::move(listener));
+        }
+        else {
+            event.slots[slot].index = static_cast<uint32_t>(event.listeners.size());
+            event.listeners.push_back(std::move(listener));
+        }
+        return SubscriptionToken{ id, slot, event.slots[slot].generation };
     }
 
-    void unsubscribe(const std::string& eventName, std::function<void()> eventListener) {
-        auto it = eventListeners.find(eventName);
-        if (it != eventListeners.end()) {
-            auto& listeners = it->second;
-            listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
-                [&eventListener](const auto& listener) {
-                    return listener.target<void()>() == eventListener.target<void()>();
-                }), listeners.end());
+    // Remove the listener in O(1); returns false if the token is stale
+    bool unsubscribe(SubscriptionToken token) {
+        if (token.event >= events.size()) {
+            return false;
+        }
+        EventListeners& event = events[token.event];
+        if (token.slot >= event.slots.size() || event.slots[token.slot].generation != token.generation) {
+            return false;
         }
+        if (++event.slots[token.slot].generation == 0) {
+            event.slots[token.slot].generation = 1;
+        }
+        if (event.publishing == 0) {
+            removeListener(event, token.slot);
+            return true;
+        }
+        // Mid-publish: stop calling it now, remove it afterwards
+        for (auto& pending : event.pendingAdds) {
+            if (pending.slot == token.slot && pending.live) {
+                pending.live = false;
+                event.freeSlots.push_back(token.slot);
+                return true;
+            }
+        }
+        event.listeners[event.slots[token.slot].index].live = false;
+        event.pendingRemovals.push_back(token.slot);
+        return true;
     }
 
     void publish(const std::string& eventName) {
-        auto it = eventListeners.find(eventName);
-        if (it != eventListeners.end()) {
-            auto& listeners = it->second;
-            for (const auto& listener : listeners) {
-                listener();
+        auto it = eventIds.find(eventName);
+        if (it != eventIds.end()) {
+            EventListeners& event = events[it->second];
+            ++event.publishing;
+            // Listeners never move during the loop: changes are deferred
+            for (const auto& listener : event.listeners) {
+                if (listener.live) {
+                    listener.callback();
+                }
+            }
+            if (--event.publishing == 0) {
+                applyPending(event);
             }
         }
     }
+
+    size_t listenerCount(const std::string& eventName) const {
+        auto it = eventIds.find(eventName);
+        return it != eventIds.end() ? events[it->second].listeners.size() : 0;
+    }
 };
 
+// Tens of thousands of listeners on one event with constant churn: each
+// round removes and re-adds a random tenth of them, then publishes
+void benchmarkListenerChurn() {
+    const int listeners = 50000;
+    const int rounds = 20;
+
+    EventManager eventManager;
+    long long calls = 0;
+    std::vector<SubscriptionToken> tokens;
+    for (int i = 0; i < listeners; ++i) {
+        tokens.push_back(eventManager.subscribe("tick", [&calls]() { ++calls; }));
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pick(0, listeners - 1);
+    std::chrono::duration<double, std::micro> churnTime{ 0 };
+    std::chrono::duration<double, std::micro> publishTime{ 0 };
+    for (int round = 0; round < rounds; ++round) {
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < listeners / 10; ++i) {
+            SubscriptionToken& token = tokens[pick(rng)];
+            eventManager.unsubscribe(token);
+            token = eventManager.subscribe("tick", [&calls]() { ++calls; });
+        }
+        auto middle = std::chrono::steady_clock::now();
+        eventManager.publish("tick");
+        churnTime += middle - begin;
+        publishTime += std::chrono::steady_clock::now() - middle;
+    }
+
+    std::cout << listeners << " listeners: " << churnTime.count() / (rounds * listeners / 10) * 1000
+        << " ns per unsubscribe+subscribe, " << publishTime.count() / rounds << " us per publish ("
+        << calls << " calls)" << std::endl;
+}
+
 // Event Consumers
 class EventConsumer1 {
 public:
@@ -57,8 +215,8 @@ int main() {
     EventConsumer1 consumer1;
     EventConsumer2 consumer2;
 
-    // Subscribe event listeners
-    eventManager.subscribe("event1", [&consumer1]() { consumer1.handleEvent(); });
+    // Subscribe event listeners, keeping the tokens to unsubscribe later
+    SubscriptionToken subscription1 = eventManager.subscribe("event1", [&consumer1]() { consumer1.handleEvent(); });
     eventManager.subscribe("event2", [&consumer2]() { consumer2.handleEvent(); });
 
     // Publish events
@@ -66,10 +224,25 @@ int main() {
     eventManager.publish("event2");
 
     // Unsubscribe event listeners
-    eventManager.unsubscribe("event1", [&consumer1]() { consumer1.handleEvent(); });
+    eventManager.unsubscribe(subscription1);
 
     // Publish event after unsubscribing
     eventManager.publish("event1");
 
+    // A stale token is rejected
+    std::cout << "Unsubscribing twice: " << (eventManager.unsubscribe(subscription1) ? "removed" : "stale token") << std::endl;
+
+    // A listener may unsubscribe itself while the event is being published
+    SubscriptionToken once;
+    once = eventManager.subscribe("event2", [&eventManager, &once]() {
+        std::cout << "One-shot listener ran." << std::endl;
+        eventManager.unsubscribe(once);
+        });
+    eventManager.publish("event2");
+    eventManager.publish("event2");
+    std::cout << "event2 listeners: " << eventManager.listenerCount("event2") << std::endl;
+
+    benchmarkListenerChurn();
+
     return 0;
 }
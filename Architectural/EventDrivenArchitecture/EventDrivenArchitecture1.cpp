@@ -1,19 +1,602 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <map>
+#include <future>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Embedded append-only message log. A log is a directory of segment files:
+//
+//   <base offset, 20 digits>.log   preallocated and memory-mapped; records back to back
+//   offsets                         committed consumer offsets, one "<name length> <name> <offset>"
+//                                   per line; the length prefix lets names contain any character
+//
+// Each record is a RecordHeader followed by the payload, padded to
+// RecordAlignment. The unwritten tail of a segment is zero, so an all-zero
+// header marks the end of the data when a segment is reopened.
+namespace logstore {
+
+constexpr size_t RecordAlignment = 8;
+
+struct RecordHeader {
+    uint32_t length;
+    uint32_t checksum;
+};
+
+// FNV-1a; never zero for an empty payload, so an all-zero header is unambiguous
+inline uint32_t checksum(std::string_view payload) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : payload) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+inline size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Producer batches are one contiguous buffer of framed messages, each a
+// uint32_t length followed by the payload, handed to the log in one call
+inline void appendToBatch(std::string& batch, std::string_view payload) {
+    uint32_t length = static_cast<uint32_t>(payload.size());
+    batch.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    batch.append(payload.data(), payload.size());
+}
+
+// Call fn for every message framed in batch
+template<typename F>
+void forEachInBatch(std::string_view batch, F&& fn) {
+    while (batch.size() >= sizeof(uint32_t)) {
+        uint32_t length;
+        std::memcpy(&length, batch.data(), sizeof(length));
+        fn(batch.substr(sizeof(length), length));
+        batch.remove_prefix(sizeof(length) + length);
+    }
+}
+
+// Replace the file at path with contents. The new data goes to a temporary
+// file that is synced before it is renamed over path, and the directory is
+// synced after, so a crash at any point leaves either the previous file or
+// the new one in place.
+inline void replaceFile(const std::string& path, std::string_view contents) {
+    std::string temp_path = path + ".tmp";
+#ifdef _WIN32
+    HANDLE file = CreateFileA(temp_path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open for writing: " + temp_path);
+    }
+    DWORD written = 0;
+    bool ok = WriteFile(file, contents.data(), static_cast<DWORD>(contents.size()), &written, nullptr)
+        && written == contents.size() && FlushFileBuffers(file);
+    CloseHandle(file);
+    if (!ok) {
+        throw std::runtime_error("Failed to write: " + temp_path);
+    }
+    if (!MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        throw std::runtime_error("Failed to replace: " + path);
+    }
+#else
+    int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open for writing: " + temp_path);
+    }
+    bool ok = true;
+    for (size_t done = 0; ok && done < contents.size();) {
+        ssize_t n = ::write(fd, contents.data() + done, contents.size() - done);
+        ok = n > 0;
+        done += ok ? static_cast<size_t>(n) : 0;
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok) {
+        throw std::runtime_error("Failed to write: " + temp_path);
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to replace: " + path);
+    }
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    int dir_fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (dir_fd < 0 || ::fsync(dir_fd) != 0) {
+        if (dir_fd >= 0) ::close(dir_fd);
+        throw std::runtime_error("Failed to sync directory of: " + path);
+    }
+    ::close(dir_fd);
+#endif
+}
+
+// Read-write shared mapping of a file, grown to at least min_size. Writes
+// land in the page cache immediately and survive a crash of the process;
+// sync() forces them to disk.
+class MappedFile {
+public:
+    MappedFile(const std::string& path, size_t min_size) {
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open segment: " + path);
+        }
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file_, &file_size);
+        size_ = std::max(static_cast<size_t>(file_size.QuadPart), min_size);
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READWRITE,
+            static_cast<DWORD>(static_cast<uint64_t>(size_) >> 32), static_cast<DWORD>(size_), nullptr);
+        void* view = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, 0) : nullptr;
+        if (!view) {
+            release();
+            throw std::runtime_error("Cannot map segment: " + path);
+        }
+        data_ = static_cast<char*>(view);
+#else
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("Cannot open segment: " + path);
+        }
+        struct stat st {};
+        if (::fstat(fd_, &st) != 0) {
+            release();
+            throw std::runtime_error("Cannot stat segment: " + path);
+        }
+        size_ = std::max(static_cast<size_t>(st.st_size), min_size);
+        if (static_cast<size_t>(st.st_size) < size_ && ::ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+            release();
+            throw std::runtime_error("Cannot grow segment: " + path);
+        }
+        void* view = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (view == MAP_FAILED) {
+            release();
+            throw std::runtime_error("Cannot map segment: " + path);
+        }
+        data_ = static_cast<char*>(view);
+#endif
+    }
+
+    ~MappedFile() {
+        release();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    char* data() { return data_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    void sync() {
+#ifdef _WIN32
+        FlushViewOfFile(data_, size_);
+        FlushFileBuffers(file_);
+#else
+        ::msync(data_, size_, MS_SYNC);
+#endif
+    }
+
+private:
+    void release() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_) ::munmap(data_, size_);
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+        data_ = nullptr;
+    }
+
+    char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+// A stored message. The payload points straight into the mapped segment and
+// stays valid for as long as the log is open.
+struct MessageView {
+    uint64_t offset;
+    std::string_view payload;
+};
+
+// One segment file plus an in-memory index from relative offset to position
+class Segment {
+public:
+    Segment(const std::string& path, uint64_t base_offset, size_t capacity)
+        : file_(path, capacity), base_offset_(base_offset) {
+        recover();
+    }
+
+    // Returns false if the record does not fit; the log then starts a new segment
+    bool append(std::string_view payload) {
+        size_t record_size = align_up(sizeof(RecordHeader) + payload.size(), RecordAlignment);
+        if (write_pos_ + record_size > file_.size()) {
+            return false;
+        }
+        // Payload first, header last: a record is only visible to recovery
+        // once its header is in place
+        char* record = file_.data() + write_pos_;
+        std::memcpy(record + sizeof(RecordHeader), payload.data(), payload.size());
+        RecordHeader header{ static_cast<uint32_t>(payload.size()), checksum(payload) };
+        std::memcpy(record, &header, sizeof(header));
+        positions_.push_back(static_cast<uint32_t>(write_pos_));
+        write_pos_ += record_size;
+        return true;
+    }
+
+    MessageView at(size_t index) const {
+        const char* record = file_.data() + positions_[index];
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+        return MessageView{ base_offset_ + index, std::string_view(record + sizeof(RecordHeader), header.length) };
+    }
+
+    uint64_t baseOffset() const { return base_offset_; }
+    uint64_t endOffset() const { return base_offset_ + positions_.size(); }
+
+    void sync() {
+        file_.sync();
+    }
+
+private:
+    // Rebuild the index by walking the records. A torn or corrupt record
+    // (from a crash mid-append) ends the segment and is wiped, so the next
+    // append cleanly overwrites it.
+    void recover() {
+        while (write_pos_ + sizeof(RecordHeader) <= file_.size()) {
+            RecordHeader header;
+            std::memcpy(&header, file_.data() + write_pos_, sizeof(header));
+            if (header.length == 0 && header.checksum == 0) {
+                return;
+            }
+            size_t record_size = align_up(sizeof(RecordHeader) + header.length, RecordAlignment);
+            if (write_pos_ + record_size > file_.size() ||
+                checksum(std::string_view(file_.data() + write_pos_ + sizeof(RecordHeader), header.length)) != header.checksum) {
+                std::memset(file_.data() + write_pos_, 0, file_.size() - write_pos_);
+                return;
+            }
+            positions_.push_back(static_cast<uint32_t>(write_pos_));
+            write_pos_ += record_size;
+        }
+    }
+
+    MappedFile file_;
+    uint64_t base_offset_;
+    std::vector<uint32_t> positions_;
+    size_t write_pos_ = 0;
+};
+
+// Append-only log of messages addressed by a dense, ever-increasing offset.
+// Appends are serialized; any number of readers may read concurrently.
+// Consumers record how far they got with commit() and resume from
+// committed() after a restart; committed offsets are persisted by flush().
+class SegmentLog {
+public:
+    explicit SegmentLog(const std::string& directory, size_t segment_size = 1 << 20)
+        : directory_(directory), segment_size_(segment_size) {
+        std::filesystem::create_directories(directory_);
+        std::vector<uint64_t> bases;
+        for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+            // Only files named by segmentPath are segments; anything else is left alone
+            std::string stem = entry.path().stem().string();
+            uint64_t base;
+            auto [end, error] = std::from_chars(stem.data(), stem.data() + stem.size(), base);
+            if (entry.path().extension() == ".log" && error == std::errc() && end == stem.data() + stem.size()) {
+                bases.push_back(base);
+            }
+        }
+        std::sort(bases.begin(), bases.end());
+        for (uint64_t base : bases) {
+            segments_.push_back(std::make_unique<Segment>(segmentPath(base), base, segment_size_));
+        }
+        if (segments_.empty()) {
+            segments_.push_back(std::make_unique<Segment>(segmentPath(0), 0, segment_size_));
+        }
+        loadOffsets();
+    }
+
+    ~SegmentLog() {
+        try {
+            flush();
+        }
+        catch (const std::exception&) {
+            // Nothing sensible to do while shutting down
+        }
+    }
+
+    SegmentLog(const SegmentLog&) = delete;
+    SegmentLog& operator=(const SegmentLog&) = delete;
+
+    // Append a message and return its offset
+    uint64_t append(std::string_view payload) {
+        return appendMessage(payload).offset;
+    }
+
+    // Append a message and return it as stored, payload pointing into the log
+    MessageView appendMessage(std::string_view payload) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        return appendLocked(payload);
+    }
+
+    // Append every message of a batch built with appendToBatch under a
+    // single lock; returns the offset of the first one. The messages get
+    // consecutive offsets.
+    uint64_t appendBatch(std::string_view batch) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        uint64_t first = segments_.back()->endOffset();
+        forEachInBatch(batch, [this](std::string_view payload) {
+            appendLocked(payload);
+            });
+        return first;
+    }
+
+    // Append up to max_messages messages starting at offset from to out;
+    // returns how many were added
+    size_t read(uint64_t from, size_t max_messages, std::vector<MessageView>& out) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        size_t added = 0;
+        for (auto it = segmentFor(from); it != segments_.end() && added < max_messages; ++it) {
+            const Segment& segment = **it;
+            for (uint64_t offset = std::max(from, segment.baseOffset()); offset < segment.endOffset() && added < max_messages; ++offset) {
+                out.push_back(segment.at(static_cast<size_t>(offset - segment.baseOffset())));
+                ++added;
+            }
+        }
+        return added;
+    }
+
+    // Call fn for every message from offset from to the current end, reading
+    // in batches; returns the offset after the last message visited
+    template<typename F>
+    uint64_t replay(uint64_t from, F&& fn) const {
+        std::vector<MessageView> batch;
+        while (true) {
+            batch.clear();
+            if (read(from, 256, batch) == 0) {
+                return from;
+            }
+            for (const MessageView& message : batch) {
+                fn(message);
+            }
+            from = batch.back().offset + 1;
+        }
+    }
+
+    uint64_t startOffset() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return segments_.front()->baseOffset();
+    }
+
+    // Offset the next appended message will get
+    uint64_t endOffset() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return segments_.back()->endOffset();
+    }
+
+    // Record that consumer has processed everything before offset
+    void commit(const std::string& consumer, uint64_t offset) {
+        std::lock_guard<std::mutex> lock(offsets_mutex_);
+        committed_[consumer] = offset;
+    }
+
+    // Offset consumer should resume from; 0 if it never committed
+    uint64_t committed(const std::string& consumer) const {
+        std::lock_guard<std::mutex> lock(offsets_mutex_);
+        auto it = committed_.find(consumer);
+        return it != committed_.end() ? it->second : 0;
+    }
+
+    // Force appended messages to disk and persist committed offsets
+    void flush() {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            for (auto& segment : segments_) {
+                segment->sync();
+            }
+        }
+        std::lock_guard<std::mutex> lock(offsets_mutex_);
+        std::string contents;
+        for (const auto& [consumer, offset] : committed_) {
+            contents += std::to_string(consumer.size()) + ' ' + consumer + ' ' + std::to_string(offset) + '\n';
+        }
+        replaceFile(directory_ + "/offsets", contents);
+    }
+
+private:
+    using SegmentList = std::vector<std::unique_ptr<Segment>>;
+
+    std::string segmentPath(uint64_t base) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%020llu.log", static_cast<unsigned long long>(base));
+        return directory_ + "/" + name;
+    }
+
+    MessageView appendLocked(std::string_view payload) {
+        if (!segments_.back()->append(payload)) {
+            uint64_t base = segments_.back()->endOffset();
+            size_t capacity = std::max(segment_size_, align_up(sizeof(RecordHeader) + payload.size(), RecordAlignment));
+            segments_.push_back(std::make_unique<Segment>(segmentPath(base), base, capacity));
+            segments_.back()->append(payload);
+        }
+        const Segment& segment = *segments_.back();
+        return segment.at(static_cast<size_t>(segment.endOffset() - segment.baseOffset() - 1));
+    }
+
+    // Segment holding offset, or the first one after it (called with mutex_ held)
+    SegmentList::const_iterator segmentFor(uint64_t offset) const {
+        auto it = std::upper_bound(segments_.begin(), segments_.end(), offset,
+            [](uint64_t value, const std::unique_ptr<Segment>& segment) { return value < segment->baseOffset(); });
+        return it == segments_.begin() ? it : std::prev(it);
+    }
+
+    void loadOffsets() {
+        std::ifstream in(directory_ + "/offsets", std::ios::binary);
+        size_t length;
+        uint64_t offset;
+        while (in >> length && in.get() == ' ') {
+            std::string consumer(length, '\0');
+            if (!in.read(consumer.data(), static_cast<std::streamsize>(length)) || !(in >> offset)) {
+                break;
+            }
+            committed_[consumer] = offset;
+        }
+    }
+
+    std::string directory_;
+    size_t segment_size_;
+    mutable std::shared_mutex mutex_;
+    SegmentList segments_;
+
+    mutable std::mutex offsets_mutex_;
+    std::unordered_map<std::string, uint64_t> committed_;
+};
+
+} // namespace logstore
 
 class MessageConsumer {
 public:
-    void consumeMessage(const std::string& message) {
+    virtual ~MessageConsumer() = default;
+
+    virtual void consumeMessage(std::string_view message) {
         // Process the consumed message
         std::cout << "Consumed message: " << message << std::endl;
     }
 };
 
 
+// A topic split into partitions, each its own SegmentLog. Messages with the
+// same key always land in the same partition and keep their order there;
+// different partitions can be consumed in parallel.
+class PartitionedTopic {
+public:
+    PartitionedTopic(const std::string& directory, size_t partitions) {
+        for (size_t i = 0; i < std::max<size_t>(1, partitions); ++i) {
+            partitions_.push_back(std::make_unique<logstore::SegmentLog>(directory + "/partition-" + std::to_string(i)));
+        }
+    }
+
+    size_t partitionCount() const {
+        return partitions_.size();
+    }
+
+    size_t partitionFor(std::string_view key) const {
+        return partitionFor(key, partitions_.size());
+    }
+
+    // Partition of key in a topic with the given partition count
+    static size_t partitionFor(std::string_view key, size_t partitions) {
+        return logstore::checksum(key) % partitions;
+    }
+
+    logstore::SegmentLog& partition(size_t index) {
+        return *partitions_[index];
+    }
+
+    // Append to the key's partition; returns the message's offset there
+    uint64_t publish(std::string_view key, std::string_view message) {
+        uint64_t offset = partitions_[partitionFor(key)]->append(message);
+        notifyAppended(1);
+        return offset;
+    }
+
+    // Append a whole producer batch to one partition; returns the first offset
+    uint64_t publishBatch(size_t partition, std::string_view batch, size_t count) {
+        uint64_t first = partitions_.at(partition)->appendBatch(batch);
+        notifyAppended(count);
+        return first;
+    }
+
+    // Count of messages published so far, for waitForMessages
+    uint64_t appendedCount() const {
+        return appended_.load(std::memory_order_seq_cst);
+    }
+
+    // Sleep until something is published after seen was read, wakeAll() is
+    // called, or the timeout passes. Publishers only take the lock when
+    // someone is waiting.
+    void waitForMessages(uint64_t seen, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        if (appended_.load(std::memory_order_seq_cst) == seen) {
+            cv_.wait_for(lock, timeout);
+        }
+        waiters_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    void wakeAll() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_all();
+    }
+
+    void flush() {
+        for (auto& partition : partitions_) {
+            partition->flush();
+        }
+    }
+
+private:
+    void notifyAppended(size_t count) {
+        appended_.fetch_add(count, std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_seq_cst) > 0) {
+            wakeAll();
+        }
+    }
+
+    std::vector<std::unique_ptr<logstore::SegmentLog>> partitions_;
+    std::atomic<uint64_t> appended_{ 0 };
+    std::atomic<int> waiters_{ 0 };
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+// Every published message is first appended to a durable log, then handed
+// to the subscribed consumers as a view into the log. Named consumers resume
+// from their committed offset, so messages published while they were away
+// (or before a restart) are delivered when they subscribe again.
 class MessageBroker {
 private:
+    struct DurableConsumer {
+        MessageConsumer* consumer;
+        std::string name;
+    };
+
+    logstore::SegmentLog log;
     std::vector<MessageConsumer*> consumers;
+    std::vector<DurableConsumer> durableConsumers;
+
+    mutable std::shared_mutex topicsMutex;
+    std::map<std::string, std::unique_ptr<PartitionedTopic>> topics;
 
 public:
     static MessageBroker& getInstance() {
@@ -22,31 +605,576 @@ public:
     }
 
     void subscribeConsumer(MessageConsumer* consumer) {
-        // Add the consumer to the list of subscribers
+        // Add the consumer to the list of subscribers; it only sees new messages
         consumers.push_back(consumer);
     }
 
-    void publishMessage(const std::string& message) {
-        // Notify all the subscribers about the published message
+    // Subscribe under a name: first catch up from the name's committed
+    // offset, then receive new messages, committing after each one
+    void subscribeConsumer(MessageConsumer* consumer, const std::string& name) {
+        uint64_t next = log.replay(log.committed(name), [consumer](const logstore::MessageView& message) {
+            consumer->consumeMessage(message.payload);
+            });
+        log.commit(name, next);
+        durableConsumers.push_back(DurableConsumer{ consumer, name });
+    }
+
+    // Deliver every stored message from offset onwards, without committing
+    uint64_t replay(MessageConsumer* consumer, uint64_t from) {
+        return log.replay(from, [consumer](const logstore::MessageView& message) {
+            consumer->consumeMessage(message.payload);
+            });
+    }
+
+    uint64_t publishMessage(std::string_view message) {
+        // Store the message, then notify all the subscribers about it
+        logstore::MessageView stored = log.appendMessage(message);
         for (auto consumer : consumers) {
-            consumer->consumeMessage(message);
+            consumer->consumeMessage(stored.payload);
+        }
+        for (const auto& durable : durableConsumers) {
+            durable.consumer->consumeMessage(stored.payload);
+            log.commit(durable.name, stored.offset + 1);
+        }
+        return stored.offset;
+    }
+
+    // Store a batch built with logstore::appendToBatch under a single log
+    // lock, then deliver its messages in order; returns the first offset
+    uint64_t publishBatch(std::string_view batch) {
+        uint64_t first = log.appendBatch(batch);
+        uint64_t next = first;
+        logstore::forEachInBatch(batch, [this, &next](std::string_view payload) {
+            ++next;
+            for (auto consumer : consumers) {
+                consumer->consumeMessage(payload);
+            }
+            for (const auto& durable : durableConsumers) {
+                durable.consumer->consumeMessage(payload);
+                log.commit(durable.name, next);
+            }
+            });
+        return first;
+    }
+
+    logstore::SegmentLog& messageLog() {
+        return log;
+    }
+
+    // Create (or reopen) a partitioned topic stored under broker-log/<name>
+    PartitionedTopic& createTopic(const std::string& name, size_t partitions) {
+        if (name.empty()) {
+            throw std::invalid_argument("Topic name must not be empty");
+        }
+        std::unique_lock<std::shared_mutex> lock(topicsMutex);
+        auto& topic = topics[name];
+        if (!topic) {
+            topic = std::make_unique<PartitionedTopic>("broker-log/topics/" + name, partitions);
+        }
+        return *topic;
+    }
+
+    PartitionedTopic& topic(const std::string& name) {
+        std::shared_lock<std::shared_mutex> lock(topicsMutex);
+        auto it = topics.find(name);
+        if (it == topics.end()) {
+            throw std::out_of_range("Unknown topic: " + name);
+        }
+        return *it->second;
+    }
+
+    // Remove a topic and its files; no consumer group may still use it
+    void deleteTopic(const std::string& name) {
+        std::unique_lock<std::shared_mutex> lock(topicsMutex);
+        topics.erase(name);
+        std::filesystem::remove_all("broker-log/topics/" + name);
+    }
+
+    // Publish to the partition chosen by key
+    uint64_t publishMessage(const std::string& topicName, std::string_view key, std::string_view message) {
+        return topic(topicName).publish(key, message);
+    }
+
+private:
+    MessageBroker() : log("broker-log") {}  // Private constructor to enforce singleton pattern
+};
+
+
+
+// Consumers that share a group name split a topic's partitions between them.
+// Each member runs on its own thread and owns a subset of the partitions;
+// when a member joins or leaves, the partitions are reassigned round-robin.
+// A partition is only ever processed by one member at a time and progress is
+// committed per partition under the group's name, so messages of a
+// partition are delivered in order even across a rebalance.
+class ConsumerGroup {
+public:
+    static constexpr size_t MaxBatch = 256;
+
+    ConsumerGroup(PartitionedTopic& topic, const std::string& name)
+        : topic_(topic), name_(name), partition_locks_(topic.partitionCount()) {}
+
+    ~ConsumerGroup() {
+        std::vector<size_t> ids;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& member : members_) {
+                ids.push_back(member->id);
+            }
+        }
+        for (size_t id : ids) {
+            leave(id);
+        }
+    }
+
+    ConsumerGroup(const ConsumerGroup&) = delete;
+    ConsumerGroup& operator=(const ConsumerGroup&) = delete;
+
+    // Add a member and start its thread; returns its member ID
+    size_t join(MessageConsumer* consumer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto member = std::make_unique<Member>();
+        member->id = next_member_id_++;
+        member->consumer = consumer;
+        Member* raw = member.get();
+        members_.push_back(std::move(member));
+        generation_.fetch_add(1);
+        raw->thread = std::thread(&ConsumerGroup::run, this, raw);
+        return raw->id;
+    }
+
+    // Stop a member after its current batch; its partitions move to the others
+    void leave(size_t memberId) {
+        std::unique_ptr<Member> member;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(members_.begin(), members_.end(),
+                [memberId](const std::unique_ptr<Member>& m) { return m->id == memberId; });
+            if (it == members_.end()) {
+                return;
+            }
+            member = std::move(*it);
+            members_.erase(it);
+            member->stop = true;
+            generation_.fetch_add(1);
         }
+        topic_.wakeAll();
+        member->thread.join();
+    }
+
+    // Partitions currently assigned to a member
+    std::vector<size_t> assignment(size_t memberId) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return assignmentLocked(memberId);
+    }
+
+    // Messages published but not yet committed by the group
+    uint64_t lag() const {
+        uint64_t total = 0;
+        for (size_t p = 0; p < topic_.partitionCount(); ++p) {
+            logstore::SegmentLog& log = topic_.partition(p);
+            total += log.endOffset() - log.committed(name_);
+        }
+        return total;
     }
 
 private:
-    MessageBroker() {}  // Private constructor to enforce singleton pattern
+    struct Member {
+        size_t id = 0;
+        MessageConsumer* consumer = nullptr;
+        std::atomic<bool> stop{ false };
+        std::thread thread;
+    };
+
+    std::vector<size_t> assignmentLocked(size_t memberId) const {
+        std::vector<size_t> partitions;
+        for (size_t index = 0; index < members_.size(); ++index) {
+            if (members_[index]->id != memberId) {
+                continue;
+            }
+            for (size_t p = index; p < topic_.partitionCount(); p += members_.size()) {
+                partitions.push_back(p);
+            }
+        }
+        return partitions;
+    }
+
+    void run(Member* member) {
+        std::vector<logstore::MessageView> batch;
+        std::vector<size_t> owned;
+        uint64_t generation = ~uint64_t(0);
+        while (!member->stop) {
+            if (generation != generation_.load()) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                generation = generation_.load();
+                owned = assignmentLocked(member->id);
+            }
+            uint64_t seen = topic_.appendedCount();
+            bool consumed = false;
+            for (size_t p : owned) {
+                // Holding the partition lock for the whole batch keeps a new
+                // owner from starting on it until this batch is committed
+                std::lock_guard<std::mutex> own(partition_locks_[p]);
+                if (generation != generation_.load()) {
+                    break;
+                }
+                logstore::SegmentLog& log = topic_.partition(p);
+                batch.clear();
+                if (log.read(log.committed(name_), MaxBatch, batch) == 0) {
+                    continue;
+                }
+                for (const auto& message : batch) {
+                    member->consumer->consumeMessage(message.payload);
+                }
+                log.commit(name_, batch.back().offset + 1);
+                consumed = true;
+            }
+            if (!consumed && generation == generation_.load()) {
+                topic_.waitForMessages(seen, std::chrono::milliseconds(50));
+            }
+        }
+    }
+
+    PartitionedTopic& topic_;
+    std::string name_;
+    std::vector<std::mutex> partition_locks_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Member>> members_;
+    size_t next_member_id_ = 0;
+    std::atomic<uint64_t> generation_{ 0 };
+};
+
+// Measure how fast a consumer group drains a topic as partitions (and
+// members, one per partition) are added. Each message costs a fixed amount
+// of consumer work.
+void benchmarkPartitionScaling() {
+    class WorkConsumer : public MessageConsumer {
+    public:
+        void consumeMessage(std::string_view message) override {
+            volatile unsigned sink = 0;
+            for (unsigned i = 0; i < 200; ++i) {
+                sink = sink + static_cast<unsigned char>(message[i % message.size()]) * i;
+            }
+        }
+    };
+
+    const int messages = 200000;
+    MessageBroker& broker = MessageBroker::getInstance();
+
+    std::cout << "Consume throughput by partition count:\n";
+    for (size_t partitions : { 1, 2, 4, 8 }) {
+        std::string name = "bench-" + std::to_string(partitions);
+        broker.deleteTopic(name);
+        PartitionedTopic& topic = broker.createTopic(name, partitions);
+        for (int i = 0; i < messages; ++i) {
+            topic.publish("key" + std::to_string(i % 1024), "payload for message " + std::to_string(i));
+        }
+
+        std::vector<WorkConsumer> consumers(partitions);
+        auto begin = std::chrono::steady_clock::now();
+        {
+            ConsumerGroup group(topic, "bench");
+            for (auto& consumer : consumers) {
+                group.join(&consumer);
+            }
+            while (group.lag() > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << "  " << partitions << " partition(s): " << static_cast<long long>(messages / elapsed.count()) << " messages/s\n";
+        broker.deleteTopic(name);
+    }
+}
+
+// Limits for BatchingProducer: a batch is sent once any of them is reached
+struct BatchConfig {
+    size_t maxMessages = 512;
+    size_t maxBytes = 64 * 1024;
+    std::chrono::milliseconds linger{ 5 };
 };
 
+// Completion of one produced message. All messages of a batch share a
+// single promise for the batch's first offset, so producing a message does
+// not allocate a shared state of its own.
+class ProduceFuture {
+public:
+    ProduceFuture() = default;
+    ProduceFuture(std::shared_future<uint64_t> batch, uint32_t index) : batch_(std::move(batch)), index_(index) {}
+
+    bool valid() const { return batch_.valid(); }
+    void wait() const { batch_.wait(); }
 
+    // Offset of the message; rethrows if its batch could not be stored
+    uint64_t get() const { return batch_.get() + index_; }
+
+private:
+    std::shared_future<uint64_t> batch_;
+    uint32_t index_ = 0;
+};
+
+// Producer that collects messages per topic partition, and for the broker's
+// own log, and hands the broker one contiguous batch at a time. A batch is sent when it reaches maxMessages
+// or maxBytes, or when its oldest message has waited for linger; a
+// background thread takes care of the linger deadline. produce() returns a
+// ProduceFuture that yields the message's offset once its batch is stored.
+class BatchingProducer {
+public:
+    explicit BatchingProducer(MessageBroker& broker, BatchConfig config = BatchConfig())
+        : broker_(broker), config_(config), sender_(&BatchingProducer::lingerLoop, this) {}
+
+    // Sends everything still buffered
+    ~BatchingProducer() {
+        {
+            std::lock_guard<std::mutex> lock(linger_mutex_);
+            stopping_ = true;
+        }
+        linger_cv_.notify_all();
+        sender_.join();
+        flush();
+    }
+
+    BatchingProducer(const BatchingProducer&) = delete;
+    BatchingProducer& operator=(const BatchingProducer&) = delete;
+
+    ProduceFuture produce(const std::string& topic, std::string_view key, std::string_view message) {
+        return produceTo(batchFor(topic, key), message);
+    }
+
+    // Produce to the broker's own log rather than a partitioned topic
+    ProduceFuture produce(std::string_view message) {
+        return produceTo(log_batch_, message);
+    }
+
+    // Send every non-empty batch now
+    void flush() {
+        for (Batch* batch : allBatches()) {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            sendLocked(*batch);
+        }
+    }
+
+    size_t batchesSent() const {
+        return batches_sent_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Batches name their topic rather than point to it: the topic is looked
+    // up on every send, so one deleted meanwhile fails the batch's future
+    // instead of leaving a dangling pointer. An empty name stands for the
+    // broker's own log.
+    struct Batch {
+        std::string topic;
+        size_t partition = 0;
+        std::mutex mutex; // also held while sending, which keeps a partition's batches in order
+        std::string buffer;
+        size_t count = 0;
+        std::promise<uint64_t> promise;      // resolves to the batch's first offset
+        std::shared_future<uint64_t> future;
+        std::chrono::steady_clock::time_point opened;
+    };
+
+    struct TopicBatches {
+        std::vector<std::unique_ptr<Batch>> partitions; // one per partition of the topic
+    };
+
+    ProduceFuture produceTo(Batch& batch, std::string_view message) {
+        std::lock_guard<std::mutex> lock(batch.mutex);
+        if (batch.count == 0) {
+            batch.promise = std::promise<uint64_t>();
+            batch.future = batch.promise.get_future().share();
+            batch.opened = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> linger_lock(linger_mutex_);
+                ++batches_opened_;
+            }
+            linger_cv_.notify_one(); // let the sender schedule this batch's deadline
+        }
+        logstore::appendToBatch(batch.buffer, message);
+        ProduceFuture result(batch.future, static_cast<uint32_t>(batch.count++));
+        if (batch.count >= config_.maxMessages || batch.buffer.size() >= config_.maxBytes) {
+            sendLocked(batch);
+        }
+        return result;
+    }
+
+    Batch& batchFor(const std::string& topicName, std::string_view key) {
+        {
+            std::shared_lock<std::shared_mutex> lock(batches_mutex_);
+            auto it = batches_.find(topicName);
+            if (it != batches_.end()) {
+                auto& partitions = it->second.partitions;
+                return *partitions[PartitionedTopic::partitionFor(key, partitions.size())];
+            }
+        }
+        size_t partitionCount = broker_.topic(topicName).partitionCount();
+        std::unique_lock<std::shared_mutex> lock(batches_mutex_);
+        auto [it, inserted] = batches_.try_emplace(topicName);
+        auto& partitions = it->second.partitions;
+        if (inserted) {
+            for (size_t p = 0; p < partitionCount; ++p) {
+                partitions.push_back(std::make_unique<Batch>());
+                partitions.back()->topic = topicName;
+                partitions.back()->partition = p;
+            }
+        }
+        return *partitions[PartitionedTopic::partitionFor(key, partitions.size())];
+    }
+
+    std::vector<Batch*> allBatches() const {
+        std::shared_lock<std::shared_mutex> lock(batches_mutex_);
+        std::vector<Batch*> result{ &log_batch_ };
+        for (const auto& [name, topic] : batches_) {
+            for (const auto& batch : topic.partitions) {
+                result.push_back(batch.get());
+            }
+        }
+        return result;
+    }
+
+    // Called with batch.mutex held
+    void sendLocked(Batch& batch) {
+        if (batch.count == 0) {
+            return;
+        }
+        try {
+            batch.promise.set_value(batch.topic.empty() ? broker_.publishBatch(batch.buffer)
+                : broker_.topic(batch.topic).publishBatch(batch.partition, batch.buffer, batch.count));
+        }
+        catch (...) {
+            batch.promise.set_exception(std::current_exception());
+        }
+        batch.buffer.clear(); // keeps its capacity for the next batch
+        batch.count = 0;
+        batches_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Send batches whose linger time has passed, then sleep until the next
+    // deadline, or with no batch open until produce() opens one
+    void lingerLoop() {
+        std::unique_lock<std::mutex> lock(linger_mutex_);
+        while (!stopping_) {
+            uint64_t seen = batches_opened_;
+            lock.unlock();
+            auto now = std::chrono::steady_clock::now();
+            auto next = std::chrono::steady_clock::time_point::max();
+            for (Batch* batch : allBatches()) {
+                std::lock_guard<std::mutex> batch_lock(batch->mutex);
+                if (batch->count == 0) {
+                    continue;
+                }
+                if (now - batch->opened >= config_.linger) {
+                    sendLocked(*batch);
+                }
+                else {
+                    next = std::min(next, batch->opened + config_.linger);
+                }
+            }
+            lock.lock();
+            auto woken = [this, seen]() { return stopping_ || batches_opened_ != seen; };
+            if (next == std::chrono::steady_clock::time_point::max()) {
+                linger_cv_.wait(lock, woken);
+            }
+            else {
+                linger_cv_.wait_until(lock, next, woken);
+            }
+        }
+    }
+
+    MessageBroker& broker_;
+    BatchConfig config_;
+
+    mutable std::shared_mutex batches_mutex_;
+    std::map<std::string, TopicBatches, std::less<>> batches_;
+    mutable Batch log_batch_;
+    std::atomic<size_t> batches_sent_{ 0 };
+
+    std::mutex linger_mutex_;
+    std::condition_variable linger_cv_;
+    uint64_t batches_opened_ = 0; // guarded by linger_mutex_, bumped by produce()
+    bool stopping_ = false;
+    std::thread sender_; // declared last: starts once everything above is initialized
+};
 
 class MessageProducer {
 public:
-	void produceMessage(const std::string& message) {
-		// Publish the message to the message broker
-		MessageBroker::getInstance().publishMessage(message);
-	}
+    explicit MessageProducer(BatchConfig config = BatchConfig())
+        : producer(MessageBroker::getInstance(), config) {}
+
+    // Messages are batched before they reach the broker; the future yields
+    // the message's offset once its batch is stored
+    ProduceFuture produceMessage(const std::string& message) {
+        return producer.produce(message);
+    }
+
+    // Publish everything produced so far
+    void flush() {
+        producer.flush();
+    }
+
+private:
+    BatchingProducer producer;
 };
 
+// Compare producing small messages one publish at a time with the batching
+// producer, which pays the broker's per-call cost (log lock, consumer
+// wake-up) once per batch. A consumer group drains the topic meanwhile, as
+// it would in production, and the time until everything is consumed counts.
+void benchmarkBatchingProducer() {
+    class CountingConsumer : public MessageConsumer {
+    public:
+        void consumeMessage(std::string_view message) override {
+            bytes += message.size();
+        }
+        size_t bytes = 0;
+    };
+
+    const int messages = 200000;
+    MessageBroker& broker = MessageBroker::getInstance();
+    std::vector<std::string> keys;
+    for (int i = 0; i < 64; ++i) {
+        keys.push_back("sensor-" + std::to_string(i));
+    }
+
+    for (bool batched : { false, true }) {
+        broker.deleteTopic("bench-produce");
+        PartitionedTopic& topic = broker.createTopic("bench-produce", 4);
+        CountingConsumer consumer;
+        size_t batches = 0;
+        auto begin = std::chrono::steady_clock::now();
+        {
+            ConsumerGroup group(topic, "bench");
+            group.join(&consumer);
+            if (batched) {
+                BatchingProducer producer(broker);
+                ProduceFuture last;
+                for (int i = 0; i < messages; ++i) {
+                    last = producer.produce("bench-produce", keys[i % keys.size()], "reading=" + std::to_string(i));
+                }
+                producer.flush();
+                last.get();
+                batches = producer.batchesSent();
+            }
+            else {
+                for (int i = 0; i < messages; ++i) {
+                    broker.publishMessage("bench-produce", keys[i % keys.size()], "reading=" + std::to_string(i));
+                }
+            }
+            while (group.lag() > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << (batched ? "  batched:        " : "  one at a time:  ") << static_cast<long long>(messages / elapsed.count())
+            << " msg/s end to end";
+        if (batched) {
+            std::cout << " (" << batches << " batches)";
+        }
+        std::cout << "\n";
+    }
+    broker.deleteTopic("bench-produce");
+}
 
 int main() {
     // Create instances of MessageProducer and MessageConsumer
@@ -59,5 +1187,84 @@ int main() {
     // Produce a message
     producer.produceMessage("Hello, world!");
 
+    // Messages are kept in the log: a consumer that subscribes later under a
+    // name catches up from its committed offset (on a second run of this
+    // program, only the messages produced since the previous run)
+    producer.produceMessage("Second message");
+    producer.flush();
+    MessageConsumer auditor;
+    MessageBroker::getInstance().subscribeConsumer(&auditor, "auditor");
+
+    logstore::SegmentLog& log = MessageBroker::getInstance().messageLog();
+    std::cout << "Log holds offsets " << log.startOffset() << " to " << log.endOffset()
+        << ", auditor committed " << log.committed("auditor") << std::endl;
+
+    // Replay the last two messages straight from the log
+    MessageBroker::getInstance().replay(&consumer, log.endOffset() - 2);
+
+    log.flush();
+
+    // Orders are keyed by customer: each customer's orders stay in order
+    // while a consumer group spreads the partitions over its members
+    class OrderConsumer : public MessageConsumer {
+    public:
+        void consumeMessage(std::string_view message) override {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::string customer(message.substr(0, message.find(':')));
+            int sequence = std::stoi(std::string(message.substr(message.find(':') + 1)));
+            inOrder = inOrder && sequence == lastSequence[customer] + 1;
+            lastSequence[customer] = sequence;
+            ++consumed;
+        }
+
+        std::mutex mutex;
+        std::unordered_map<std::string, int> lastSequence;
+        bool inOrder = true;
+        size_t consumed = 0;
+    };
+
+    MessageBroker& broker = MessageBroker::getInstance();
+    broker.deleteTopic("orders");
+    broker.createTopic("orders", 4);
+    OrderConsumer orders;
+    {
+        ConsumerGroup billing(broker.topic("orders"), "billing");
+        size_t first = billing.join(&orders);
+        billing.join(&orders);
+        for (int sequence = 1; sequence <= 1000; ++sequence) {
+            for (const char* customer : { "alice", "bob", "carol", "dave", "erin" }) {
+                broker.publishMessage("orders", customer, std::string(customer) + ":" + std::to_string(sequence));
+            }
+            if (sequence == 300) {
+                billing.join(&orders); // rebalance while messages are flowing
+            }
+            if (sequence == 600) {
+                billing.leave(first);
+            }
+        }
+        while (billing.lag() > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    std::cout << "Consumer group processed " << orders.consumed << " orders, "
+        << (orders.inOrder ? "each customer in order" : "OUT OF ORDER") << std::endl;
+    broker.deleteTopic("orders");
+
+    // Batched, asynchronous produce: the future completes once the batch
+    // holding the message has been written (here after the 5 ms linger)
+    broker.createTopic("metrics", 2);
+    {
+        BatchingProducer batching(broker);
+        ProduceFuture cpu = batching.produce("metrics", "host-1", "cpu=0.42");
+        ProduceFuture memory = batching.produce("metrics", "host-1", "memory=0.73");
+        std::cout << "Batched messages stored at offsets " << cpu.get() << " and " << memory.get()
+            << " of partition " << broker.topic("metrics").partitionFor("host-1") << std::endl;
+    }
+    broker.deleteTopic("metrics");
+
+    benchmarkPartitionScaling();
+    std::cout << "Produce 200000 small messages with a consumer group attached:\n";
+    benchmarkBatchingProducer();
+
     return 0;
 }
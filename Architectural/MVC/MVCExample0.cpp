@@ -1,37 +1,196 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+using ChangeMask = uint32_t;
+
+// Bits of a ChangeMask, one per Model field
+enum ModelField : ChangeMask {
+    DataField = 1u << 0,
+    LabelField = 1u << 1,
+    LimitField = 1u << 2,
+};
 
 class Observer {
 public:
     virtual ~Observer() = default;
-    virtual void update() = 0;
+    // Called once per committed change with the fields that changed
+    virtual void update(ChangeMask changed) = 0;
 };
 
 class Model {
 
     int data;
+    std::string label;
+    int limit = 0;
 
     std::vector<std::weak_ptr<Observer>> observers;
 
+    // Fields changed since the last notification; outside a transaction
+    // every setter commits straight away
+    ChangeMask dirty = 0;
+
+    // State at each open transaction's begin(), innermost last, so that
+    // discard() can roll that level back
+    struct Saved {
+        int data;
+        std::string label;
+        int limit;
+        ChangeMask dirty;
+    };
+    std::vector<Saved> transactions;
+
+    int notifying = 0;
+    bool hasExpired = false;
+
+    template <typename T>
+    void assign(T& field, T value, ChangeMask bit) {
+        if (field == value) {
+            return;
+        }
+        field = std::move(value);
+        dirty |= bit;
+        if (transactions.empty()) {
+            flush();
+        }
+    }
+
+    void flush() {
+        ChangeMask changed = dirty;
+        dirty = 0;
+        if (changed != 0) {
+            notify(changed);
+        }
+    }
+
+    // Drop the observers found expired while notifying
+    void compact() {
+        observers.erase(std::remove_if(observers.begin(), observers.end(),
+            [](const std::weak_ptr<Observer>& observer) { return observer.expired(); }), observers.end());
+        hasExpired = false;
+    }
+
 public:
+    // Groups the setters made during its lifetime into one notification
+    class Transaction {
+        Model& model;
+        int uncaught = std::uncaught_exceptions();
+        bool finished = false;
+    public:
+        explicit Transaction(Model& model) : model(model) { model.begin(); }
+
+        // Commit now; an exception thrown by an observer reaches the caller
+        void commit() {
+            finished = true;
+            model.commit();
+        }
+
+        // Commits unless commit() was called. When the scope is left by an
+        // exception the changes are rolled back instead, and an observer
+        // that throws here cannot escape the destructor.
+        ~Transaction() {
+            if (finished) {
+                return;
+            }
+            if (std::uncaught_exceptions() > uncaught) {
+                model.discard();
+                return;
+            }
+            try {
+                model.commit();
+            }
+            catch (const std::exception& ex) {
+                std::cerr << "Observer failed during commit: " << ex.what() << std::endl;
+            }
+            catch (...) {
+                std::cerr << "Observer failed during commit" << std::endl;
+            }
+        }
+
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+    };
+
     Model(int data = 0) : data(data) {}
 
     int getData() const { return data; }
+    const std::string& getLabel() const { return label; }
+    int getLimit() const { return limit; }
 
     void attach(std::shared_ptr<Observer> observer) {
         observers.emplace_back(observer);
     }
 
+    size_t observerCount() const { return observers.size(); }
+
     void setData(int data) {
-        this->data = data;
-        notify();
+        assign(this->data, data, DataField);
+    }
+
+    void setLabel(std::string label) {
+        assign(this->label, std::move(label), LabelField);
     }
 
-    void notify() {
-        for (auto& observer : observers) {
-            if (auto observer_shared = observer.lock()) {
-                observer_shared->update();
+    void setLimit(int limit) {
+        assign(this->limit, limit, LimitField);
+    }
+
+    // Transactions nest; the outermost commit sends a single notification
+    // carrying every field that changed inside it
+    void begin() {
+        transactions.push_back(Saved{ data, label, limit, dirty });
+    }
+
+    void commit() {
+        if (transactions.empty()) {
+            return;
+        }
+        transactions.pop_back();
+        if (transactions.empty()) {
+            flush();
+        }
+    }
+
+    // End a transaction by restoring every field, and the pending change
+    // mask, to what they were at its begin(). Works the same at any depth:
+    // an enclosing transaction carries on as if the inner one never ran.
+    void discard() {
+        if (transactions.empty()) {
+            return;
+        }
+        Saved& saved = transactions.back();
+        data = saved.data;
+        label = std::move(saved.label);
+        limit = saved.limit;
+        dirty = saved.dirty;
+        transactions.pop_back();
+    }
+
+    void notify(ChangeMask changed) {
+        // Leaves the notifying state even if an observer throws
+        struct Scope {
+            Model& model;
+            ~Scope() {
+                if (--model.notifying == 0 && model.hasExpired) {
+                    model.compact();
+                }
+            }
+        } scope{ *this };
+        ++notifying;
+        // By index and up to the current count: an observer may attach
+        // another one while it is being updated
+        size_t count = observers.size();
+        for (size_t i = 0; i < count; ++i) {
+            if (auto observer_shared = observers[i].lock()) {
+                observer_shared->update(changed);
+            }
+            else {
+                hasExpired = true;
             }
         }
     }
@@ -42,13 +201,26 @@ public:
 
 class View : public std::enable_shared_from_this<View>, public Observer {
     std::shared_ptr<Model> model;
+    int refreshes = 0;
 public:
     View(std::shared_ptr<Model> model) : model(model) {
       
     }
 
-    void update() override {
-        // Render the data from the model
+    void update(ChangeMask changed) override {
+        // Render the changed parts of the model
+        ++refreshes;
+        std::cout << "View refresh " << refreshes << ":";
+        if (changed & DataField) {
+            std::cout << " data = " << model->getData();
+        }
+        if (changed & LabelField) {
+            std::cout << " label = " << model->getLabel();
+        }
+        if (changed & LimitField) {
+            std::cout << " limit = " << model->getLimit();
+        }
+        std::cout << std::endl;
     }
     void print() {
         std::cout << "View connected to Model with data = " << model->getData() << std::endl;
@@ -58,16 +230,25 @@ public:
 class Controller {
 
     std::shared_ptr<Model> model;
+    int inputs = 0;
 
 public:
 
     Controller(std::shared_ptr<Model> model) : model(model) {}
 
-    void handleInput() {
+    // Returns false once input runs out
+    bool handleInput() {
         int newData;
         std::cout << "Enter new data: ";
-        std::cin >> newData;
+        if (!(std::cin >> newData)) {
+            return false;
+        }
+        ++inputs;
+        // Both fields change together, so the view refreshes once
+        Model::Transaction transaction(*model);
         model->setData(newData);
+        model->setLabel("input " + std::to_string(inputs));
+        return true;
     }
 
     void print() {
@@ -93,8 +274,7 @@ public:
 
     void run() {
 
-        while (true) {
-            controller->handleInput();
+        while (controller->handleInput()) {
 
             //testing purpose
             print();
@@ -111,7 +291,51 @@ public:
 };
 
 
+// A burst of setters inside a transaction reaches the view as one refresh,
+// and an observer that went away is dropped after the first notify finds it
+void demonstrateTransactions() {
+    auto model = std::make_shared<Model>();
+    auto view = std::make_shared<View>(model);
+    model->attach(view);
+    model->attach(std::make_shared<View>(model)); // expires immediately
+
+    model->setData(1);
+    std::cout << "Observers after first notify: " << model->observerCount() << std::endl;
+
+    {
+        Model::Transaction transaction(*model);
+        model->setData(2);
+        model->setLabel("temperature");
+        model->setLimit(100);
+        model->setData(3);
+    }
+
+    model->begin();
+    model->setLimit(100); // unchanged, nothing to report
+    model->commit();
+
+    model->begin();
+    model->setLimit(120);
+    model->begin(); // nested: only the outer commit notifies
+    model->setData(4);
+    model->commit();
+    model->commit();
+
+    // A transaction left by an exception rolls back, so the view never
+    // shows a half-applied update
+    try {
+        Model::Transaction transaction(*model);
+        model->setData(5);
+        throw std::runtime_error("input rejected");
+    }
+    catch (const std::exception& ex) {
+        std::cout << "Rolled back after '" << ex.what() << "': data = " << model->getData() << std::endl;
+    }
+}
+
 int main() {
+    demonstrateTransactions();
+
     Application app;
     app.run();
     app.print();
@@ -9,13 +9,48 @@ components in a loosely coupled manner. It acts as a central hub or broker for e
 
 #include <iostream>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <functional>
+#include <string>
+#include <string_view>
+#include <deque>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
 
-// Event data structure
+// Event data structure. Both fields are views: the name refers to the
+// aggregator's interned copy and the data to the publisher's buffer, so they
+// are only valid for the duration of onEvent.
 struct EventData {
-    std::string eventName;
-    std::string eventData;
+    std::string_view eventName;
+    std::string_view eventData;
+};
+
+// Handle to an interned event name, resolved once to a dense integer ID
+class Topic {
+public:
+    Topic() = default;
+
+    uint32_t id() const { return id_; }
+    bool valid() const { return id_ != Invalid; }
+
+    bool operator==(Topic other) const { return id_ == other.id_; }
+    bool operator!=(Topic other) const { return id_ != other.id_; }
+
+private:
+    friend class EventAggregator;
+
+    static constexpr uint32_t Invalid = UINT32_MAX;
+
+    explicit Topic(uint32_t id) : id_(id) {}
+
+    uint32_t id_ = Invalid;
 };
 
 // Event subscriber interface
@@ -25,32 +60,540 @@ public:
     virtual void onEvent(const EventData& eventData) = 0;
 };
 
-// Event aggregator
+class Mailbox;
+
+// Shared worker pool for asynchronous delivery. Mailboxes with pending
+// events are queued here; a worker runs one mailbox at a time, so a
+// subscriber never sees two of its events concurrently, and re-queues it
+// after a bounded number of events so one busy subscriber cannot monopolize
+// a worker.
+class DeliveryPool {
+public:
+    static constexpr size_t EventsPerTurn = 32;
+
+    explicit DeliveryPool(size_t workers) {
+        for (size_t i = 0; i < std::max<size_t>(1, workers); ++i) {
+            workers_.emplace_back(&DeliveryPool::workerLoop, this);
+        }
+    }
+
+    DeliveryPool(const DeliveryPool&) = delete;
+    DeliveryPool& operator=(const DeliveryPool&) = delete;
+
+    // Delivers everything already queued, then joins the workers
+    ~DeliveryPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void schedule(Mailbox* mailbox) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(mailbox);
+        }
+        ready_cv_.notify_one();
+    }
+
+    // Block until every scheduled mailbox has been drained
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this] { return ready_.empty() && active_ == 0; });
+    }
+
+    size_t workerCount() const {
+        return workers_.size();
+    }
+
+private:
+    void workerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;
+    std::condition_variable idle_cv_;
+    std::deque<Mailbox*> ready_;
+    size_t active_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+// What a mailbox does when it is full
+enum class Backpressure {
+    Block,      // the publisher waits for the subscriber to catch up
+    DropOldest, // the oldest undelivered event is discarded
+    DropNewest  // the event being published is discarded
+};
+
+struct MailboxStats {
+    size_t depth = 0;
+    size_t peakDepth = 0;
+    size_t delivered = 0;
+    size_t dropped = 0;
+};
+
+// Bounded queue in front of one subscriber. It is itself a subscriber: the
+// aggregator publishes into it on the publisher's thread, and a DeliveryPool
+// worker later calls the real subscriber. Slots keep their string buffers,
+// so once warmed up, queuing an event copies the payload without allocating.
+class Mailbox : public IEventSubscriber {
+public:
+    Mailbox(IEventSubscriber* target, size_t capacity, Backpressure policy, DeliveryPool& pool)
+        : target_(target), slots_(std::max<size_t>(1, capacity)), policy_(policy), pool_(pool) {}
+
+    // Called on the publisher's thread. The event name must outlive the
+    // delivery, which holds for names interned by the aggregator.
+    void onEvent(const EventData& eventData) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (count_ == slots_.size()) {
+            switch (policy_) {
+            case Backpressure::DropNewest:
+                ++dropped_;
+                return;
+            case Backpressure::DropOldest:
+                head_ = (head_ + 1) % slots_.size();
+                --count_;
+                ++dropped_;
+                break;
+            case Backpressure::Block:
+                not_full_.wait(lock, [this] { return count_ < slots_.size(); });
+                break;
+            }
+        }
+        Slot& slot = slots_[(head_ + count_) % slots_.size()];
+        slot.name = eventData.eventName;
+        slot.data.assign(eventData.eventData.data(), eventData.eventData.size());
+        peak_depth_ = std::max(peak_depth_, ++count_);
+        bool schedule = !scheduled_;
+        scheduled_ = true;
+        lock.unlock();
+        if (schedule) {
+            pool_.schedule(this);
+        }
+    }
+
+    // Called by a pool worker: deliver up to budget events. Returns true if
+    // events remain and the mailbox should be scheduled again.
+    bool deliver(size_t budget) {
+        for (size_t delivered = 0; delivered < budget; ++delivered) {
+            std::string_view name;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (count_ == 0) {
+                    scheduled_ = false;
+                    return false;
+                }
+                // Swap buffers instead of copying; both keep their capacity
+                Slot& slot = slots_[head_];
+                name = slot.name;
+                std::swap(current_, slot.data);
+                head_ = (head_ + 1) % slots_.size();
+                --count_;
+            }
+            not_full_.notify_one();
+            target_->onEvent(EventData{ name, current_ });
+            delivered_.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        scheduled_ = count_ > 0;
+        return scheduled_;
+    }
+
+    MailboxStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return MailboxStats{ count_, peak_depth_, delivered_.load(std::memory_order_relaxed), dropped_ };
+    }
+
+    IEventSubscriber* target() const {
+        return target_;
+    }
+
+private:
+    struct Slot {
+        std::string_view name;
+        std::string data;
+    };
+
+    IEventSubscriber* target_;
+    std::vector<Slot> slots_;
+    Backpressure policy_;
+    DeliveryPool& pool_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    size_t peak_depth_ = 0;
+    size_t dropped_ = 0;
+    bool scheduled_ = false; // queued in the pool or being delivered
+    std::atomic<size_t> delivered_{ 0 };
+    std::string current_; // payload being delivered; only touched by the worker running this mailbox
+};
+
+inline void DeliveryPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        ready_cv_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+        if (ready_.empty()) {
+            return; // stopping and fully drained
+        }
+        Mailbox* mailbox = ready_.front();
+        ready_.pop_front();
+        ++active_;
+        lock.unlock();
+        bool more = mailbox->deliver(EventsPerTurn);
+        lock.lock();
+        --active_;
+        if (more) {
+            ready_.push_back(mailbox);
+            ready_cv_.notify_one();
+        }
+        else if (ready_.empty() && active_ == 0) {
+            idle_cv_.notify_all();
+        }
+    }
+}
+
+// Event aggregator. Subscriptions are patterns of '.'-separated segments
+// where '*' matches exactly one segment and '#' matches zero or more, so
+// "Order.*" receives "Order.Created" and "Order.#" also receives
+// "Order.Created.EU". Patterns are stored in a segment trie; the subscribers
+// matching a topic are computed once and cached per topic until the
+// subscriptions change.
+//
+// Subscribers are called on the publisher's thread by default. Subscribing
+// with subscribeAsync routes a subscriber through its own bounded Mailbox
+// instead, delivered by a shared worker pool, so a slow subscriber only
+// holds up its own mailbox. The aggregator itself is used from one thread.
 class EventAggregator {
 public:
-    // Publish an event
-    void publishEvent(const std::string& eventName, const std::string& eventData) {
-        EventData event{ eventName, eventData };
-        for (auto& subscriber : subscribers_[eventName]) {
+    explicit EventAggregator(size_t deliveryWorkers = std::max(2u, std::thread::hardware_concurrency()))
+        : delivery_workers_(deliveryWorkers) {}
+
+    // Intern an event name; the same name always yields the same handle
+    Topic topic(std::string_view eventName) {
+        auto [it, inserted] = topic_ids_.try_emplace(std::string(eventName), static_cast<uint32_t>(names_.size()));
+        if (inserted) {
+            names_.push_back(it->first);
+            match_cache_.emplace_back();
+        }
+        return Topic(it->second);
+    }
+
+    // Look up an already interned name without interning it
+    Topic findTopic(const std::string& eventName) const {
+        auto it = topic_ids_.find(eventName);
+        return it != topic_ids_.end() ? Topic(it->second) : Topic();
+    }
+
+    Topic findTopic(std::string_view eventName) const {
+        return findTopic(std::string(eventName));
+    }
+
+    std::string_view topicName(Topic topic) const {
+        return names_.at(topic.id());
+    }
+
+    // Publish an event by handle: after the first publish (or after a
+    // subscription change) this is a cache lookup with no hashing, no
+    // allocation, and the payload is passed to subscribers by reference
+    void publishEvent(Topic topic, std::string_view eventData) const {
+        if (!topic.valid() || topic.id() >= match_cache_.size()) {
+            return;
+        }
+        EventData event{ names_[topic.id()], eventData };
+        for (auto* subscriber : matches(topic)) {
             subscriber->onEvent(event);
         }
     }
 
-    // Subscribe to an event
-    void subscribeToEvent(const std::string& eventName, IEventSubscriber* subscriber) {
-        subscribers_[eventName].push_back(subscriber);
+    // Publish an event by name. A name is interned (and its matches cached)
+    // the first time it has subscribers; names nobody listens to are not
+    // added to the table.
+    void publishEvent(const std::string& eventName, std::string_view eventData) {
+        Topic known = findTopic(eventName);
+        if (!known.valid()) {
+            std::vector<IEventSubscriber*> subscribers;
+            collectMatches(eventName, subscribers);
+            if (subscribers.empty()) {
+                return;
+            }
+            known = topic(eventName);
+            match_cache_[known.id()] = MatchCache{ generation_, std::move(subscribers) };
+        }
+        publishEvent(known, eventData);
+    }
+
+    // Subscribe to an event name or pattern
+    void subscribeToEvent(const std::string& pattern, IEventSubscriber* subscriber) {
+        TrieNode* node = &root_;
+        for (std::string_view segment : split(pattern)) {
+            std::unique_ptr<TrieNode>& child = segment == "*" ? node->star
+                : segment == "#" ? node->hash
+                : node->children[std::string(segment)];
+            if (!child) {
+                child = std::make_unique<TrieNode>();
+            }
+            node = child.get();
+        }
+        node->subscribers.push_back(subscriber);
+        ++generation_;
+    }
+
+    void subscribeToEvent(Topic topic, IEventSubscriber* subscriber) {
+        subscribeToEvent(std::string(topicName(topic)), subscriber);
+    }
+
+    // Unsubscribe from an event name or pattern
+    void unsubscribeFromEvent(const std::string& pattern, IEventSubscriber* subscriber) {
+        erase(root_, split(pattern), 0, subscriber);
+        ++generation_;
+    }
+
+    void unsubscribeFromEvent(Topic topic, IEventSubscriber* subscriber) {
+        unsubscribeFromEvent(std::string(topicName(topic)), subscriber);
     }
 
-    // Unsubscribe from an event
-    void unsubscribeFromEvent(const std::string& eventName, IEventSubscriber* subscriber) {
-        auto& subscribers = subscribers_[eventName];
-        subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), subscriber), subscribers.end());
+    // Subscribe with asynchronous delivery. All async subscriptions of one
+    // subscriber share a mailbox; its capacity and policy are fixed by the
+    // first call. With Backpressure::Block a subscriber must not publish to
+    // a topic it is subscribed to, or it could wait on its own mailbox.
+    Mailbox& subscribeAsync(const std::string& pattern, IEventSubscriber* subscriber,
+        size_t capacity = 1024, Backpressure policy = Backpressure::Block) {
+        if (!delivery_) {
+            delivery_ = std::make_unique<DeliveryPool>(delivery_workers_);
+        }
+        auto& mailbox = mailboxes_[subscriber];
+        if (!mailbox) {
+            mailbox = std::make_unique<Mailbox>(subscriber, capacity, policy, *delivery_);
+        }
+        subscribeToEvent(pattern, mailbox.get());
+        return *mailbox;
+    }
+
+    void unsubscribeAsync(const std::string& pattern, IEventSubscriber* subscriber) {
+        auto it = mailboxes_.find(subscriber);
+        if (it != mailboxes_.end()) {
+            unsubscribeFromEvent(pattern, it->second.get());
+        }
+    }
+
+    MailboxStats mailboxStats(IEventSubscriber* subscriber) const {
+        auto it = mailboxes_.find(subscriber);
+        return it != mailboxes_.end() ? it->second->stats() : MailboxStats{};
+    }
+
+    // Wait until every asynchronously published event has been delivered
+    void flushAsync() {
+        if (delivery_) {
+            delivery_->waitIdle();
+        }
+    }
+
+    size_t topicCount() const {
+        return names_.size();
     }
 
 private:
-    std::unordered_map<std::string, std::vector<IEventSubscriber*>> subscribers_;
+    struct TrieNode {
+        std::unordered_map<std::string, std::unique_ptr<TrieNode>> children;
+        std::unique_ptr<TrieNode> star; // '*'
+        std::unique_ptr<TrieNode> hash; // '#'
+        std::vector<IEventSubscriber*> subscribers;
+
+        bool empty() const {
+            return children.empty() && !star && !hash && subscribers.empty();
+        }
+    };
+
+    // Subscribers of one topic, valid while generation matches generation_
+    struct MatchCache {
+        uint64_t generation = 0;
+        std::vector<IEventSubscriber*> subscribers;
+    };
+
+    static std::vector<std::string_view> split(std::string_view name) {
+        std::vector<std::string_view> segments;
+        size_t begin = 0;
+        while (true) {
+            size_t dot = name.find('.', begin);
+            segments.push_back(name.substr(begin, dot == std::string_view::npos ? std::string_view::npos : dot - begin));
+            if (dot == std::string_view::npos) {
+                return segments;
+            }
+            begin = dot + 1;
+        }
+    }
+
+    const std::vector<IEventSubscriber*>& matches(Topic topic) const {
+        MatchCache& cache = match_cache_[topic.id()];
+        if (cache.generation != generation_) {
+            cache.subscribers.clear();
+            collectMatches(names_[topic.id()], cache.subscribers);
+            cache.generation = generation_;
+        }
+        return cache.subscribers;
+    }
+
+    // Every subscriber whose pattern matches name, in first-match order. A
+    // subscriber reached through several patterns is delivered to once;
+    // repeats are dropped in one hashed pass so wide fan-out stays linear.
+    void collectMatches(std::string_view name, std::vector<IEventSubscriber*>& out) const {
+        collect(root_, split(name), 0, out);
+        if (out.size() < 2) {
+            return;
+        }
+        std::unordered_set<IEventSubscriber*> seen;
+        seen.reserve(out.size());
+        size_t kept = 0;
+        for (auto* subscriber : out) {
+            if (seen.insert(subscriber).second) {
+                out[kept++] = subscriber;
+            }
+        }
+        out.resize(kept);
+    }
+
+    // Gather the subscribers of every pattern matching segments[index...],
+    // repeats included
+    static void collect(const TrieNode& node, const std::vector<std::string_view>& segments, size_t index,
+        std::vector<IEventSubscriber*>& out) {
+        if (node.hash) {
+            for (size_t next = index; next <= segments.size(); ++next) {
+                collect(*node.hash, segments, next, out);
+            }
+        }
+        if (index == segments.size()) {
+            out.insert(out.end(), node.subscribers.begin(), node.subscribers.end());
+            return;
+        }
+        auto it = node.children.find(std::string(segments[index]));
+        if (it != node.children.end()) {
+            collect(*it->second, segments, index + 1, out);
+        }
+        if (node.star) {
+            collect(*node.star, segments, index + 1, out);
+        }
+    }
+
+    // Remove a subscription and prune nodes left empty; returns true if node
+    // itself is now empty
+    static bool erase(TrieNode& node, const std::vector<std::string_view>& segments, size_t index,
+        IEventSubscriber* subscriber) {
+        if (index == segments.size()) {
+            node.subscribers.erase(std::remove(node.subscribers.begin(), node.subscribers.end(), subscriber),
+                node.subscribers.end());
+            return node.empty();
+        }
+        std::string_view segment = segments[index];
+        if (segment == "*" || segment == "#") {
+            std::unique_ptr<TrieNode>& child = segment == "*" ? node.star : node.hash;
+            if (child && erase(*child, segments, index + 1, subscriber)) {
+                child.reset();
+            }
+        }
+        else {
+            auto it = node.children.find(std::string(segment));
+            if (it != node.children.end() && erase(*it->second, segments, index + 1, subscriber)) {
+                node.children.erase(it);
+            }
+        }
+        return node.empty();
+    }
+
+    std::unordered_map<std::string, uint32_t> topic_ids_;
+    std::deque<std::string> names_; // indexed by topic ID; a deque keeps the views stable
+    TrieNode root_;
+    uint64_t generation_ = 1; // bumped on every subscription change
+    mutable std::vector<MatchCache> match_cache_; // indexed by topic ID
+
+    size_t delivery_workers_;
+    std::unordered_map<IEventSubscriber*, std::unique_ptr<Mailbox>> mailboxes_;
+    std::unique_ptr<DeliveryPool> delivery_; // declared last: joined before the mailboxes go away
 };
 
+// Compare publishing by name with publishing by interned handle
+void benchmarkPublish() {
+    class CountingSubscriber : public IEventSubscriber {
+    public:
+        void onEvent(const EventData& eventData) override {
+            bytes += eventData.eventData.size();
+        }
+        size_t bytes = 0;
+    };
+
+    const int publishes = 1000000;
+    EventAggregator aggregator;
+    CountingSubscriber counter;
+    aggregator.subscribeToEvent("Order.Created", &counter);
+    const std::string name = "Order.Created";
+    const std::string payload = "{\"id\": 42, \"total\": 99.95, \"currency\": \"EUR\"}";
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < publishes; ++i) {
+        aggregator.publishEvent(name, payload);
+    }
+    std::chrono::duration<double, std::nano> byName = std::chrono::steady_clock::now() - begin;
+
+    Topic orderCreated = aggregator.topic("Order.Created");
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < publishes; ++i) {
+        aggregator.publishEvent(orderCreated, payload);
+    }
+    std::chrono::duration<double, std::nano> byHandle = std::chrono::steady_clock::now() - begin;
+
+    std::cout << "Publish by name: " << byName.count() / publishes << " ns, by handle: "
+        << byHandle.count() / publishes << " ns (" << counter.bytes << " bytes seen)" << std::endl;
+}
+
+// Publish across many distinct topics with wildcard subscribers: the first
+// pass resolves each topic against the trie, later passes hit the cache
+void benchmarkWildcardPublish() {
+    class CountingSubscriber : public IEventSubscriber {
+    public:
+        void onEvent(const EventData&) override {
+            ++count;
+        }
+        size_t count = 0;
+    };
+
+    const int regions = 1000;
+    const char* entities[] = { "Order", "Payment", "Shipment", "Invoice" };
+    const char* actions[] = { "Created", "Updated", "Cancelled", "Completed", "Failed" };
+
+    EventAggregator aggregator;
+    std::vector<Topic> topics;
+    for (const char* entity : entities) {
+        for (const char* action : actions) {
+            for (int region = 0; region < regions; ++region) {
+                topics.push_back(aggregator.topic(std::string(entity) + "." + action + ".R" + std::to_string(region)));
+            }
+        }
+    }
+
+    CountingSubscriber allOrders, allFailures, everything, oneRegion;
+    aggregator.subscribeToEvent("Order.#", &allOrders);
+    aggregator.subscribeToEvent("*.Failed.*", &allFailures);
+    aggregator.subscribeToEvent("#", &everything);
+    aggregator.subscribeToEvent("Payment.Created.R7", &oneRegion);
+
+    for (int pass = 0; pass < 2; ++pass) {
+        auto begin = std::chrono::steady_clock::now();
+        for (Topic topic : topics) {
+            aggregator.publishEvent(topic, "payload");
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << (pass == 0 ? "Wildcard publish, cold cache: " : "Wildcard publish, warm cache: ")
+            << elapsed.count() / topics.size() << " ns per topic" << std::endl;
+    }
+    std::cout << "Delivered: Order.# " << allOrders.count << ", *.Failed.* " << allFailures.count
+        << ", # " << everything.count << ", Payment.Created.R7 " << oneRegion.count << std::endl;
+}
+
 // Event subscriber implementations
 
 class EventSubscriberA : public IEventSubscriber {
@@ -90,6 +633,62 @@ int main() {
     // Publish Event2 again
     eventAggregator.publishEvent("Event2", "Event2 Data");
 
+    // Hot paths resolve the name once and publish by handle
+    Topic event1 = eventAggregator.topic("Event1");
+    eventAggregator.publishEvent(event1, "Event1 Data via handle");
+
+    // Publishing a name nobody subscribed to does not create a topic
+    eventAggregator.publishEvent("Unknown", "ignored");
+    std::cout << "Topics: " << eventAggregator.topicCount() << std::endl;
+
+    // Wildcard subscriptions: '*' is one segment, '#' any number of segments
+    eventAggregator.subscribeToEvent("Order.*", &subscriberA);
+    eventAggregator.subscribeToEvent("Order.#", &subscriberB);
+    eventAggregator.publishEvent("Order.Created", "order 1");
+    eventAggregator.publishEvent("Order.Created.EU", "order 2");
+
+    // A slow subscriber behind a small drop-oldest mailbox no longer holds
+    // up the publisher or the other subscribers
+    class SlowSubscriber : public IEventSubscriber {
+    public:
+        void onEvent(const EventData& eventData) override {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            last = std::string(eventData.eventData);
+        }
+        std::string last;
+    };
+
+    class CountingSubscriber : public IEventSubscriber {
+    public:
+        void onEvent(const EventData&) override {
+            ++count;
+        }
+        size_t count = 0;
+    };
+
+    SlowSubscriber slow;
+    CountingSubscriber fast;
+    eventAggregator.subscribeAsync("Sensor.#", &slow, 4, Backpressure::DropOldest);
+    eventAggregator.subscribeAsync("Sensor.#", &fast, 256, Backpressure::Block);
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < 50; ++i) {
+        eventAggregator.publishEvent("Sensor.Temperature", "reading " + std::to_string(i));
+    }
+    std::chrono::duration<double, std::milli> publishTime = std::chrono::steady_clock::now() - begin;
+    eventAggregator.flushAsync();
+
+    MailboxStats slowStats = eventAggregator.mailboxStats(&slow);
+    MailboxStats fastStats = eventAggregator.mailboxStats(&fast);
+    std::cout << "Published 50 events in " << publishTime.count() << " ms" << std::endl;
+    std::cout << "Slow subscriber: delivered " << slowStats.delivered << ", dropped " << slowStats.dropped
+        << ", peak depth " << slowStats.peakDepth << ", last '" << slow.last << "'" << std::endl;
+    std::cout << "Fast subscriber: delivered " << fastStats.delivered << ", dropped " << fastStats.dropped
+        << ", peak depth " << fastStats.peakDepth << std::endl;
+
+    benchmarkPublish();
+    benchmarkWildcardPublish();
+
     return 0;
 }
 
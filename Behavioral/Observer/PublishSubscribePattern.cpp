@@ -1,46 +1,419 @@
 #include <iostream>
 #include <vector>
+#include <deque>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <random>
 
-// Forward declaration of Subscriber
-class Subscriber;
+// Subscriber class
+class Subscriber {
+    std::string name;
+
+public:
+    explicit Subscriber(const std::string& name) : name(name) {}
+    virtual ~Subscriber() = default;
+
+    // May run on any of the publisher's notify threads
+    virtual void receiveEvent(const std::string& event) {
+        std::cout << "Subscriber " << name << " received event: " << event << std::endl;
+    }
+};
+
+// Persistent threads for splitting a loop into chunks. The calling thread
+// takes chunks too, so a pool without threads simply runs the loop inline
+// and a nested loop can never wait on busy workers.
+class NotifyPool {
+    struct Job {
+        void (*run)(void* context, size_t begin, size_t end);
+        void* context;
+        size_t count;
+        size_t chunk;
+        std::atomic<size_t> next{ 0 };
+        int users = 0; // workers inside runChunks, guarded by mutex
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::deque<Job*> jobs;
+    bool stopping = false;
+
+    static void runChunks(Job& job) {
+        for (size_t begin = job.next.fetch_add(job.chunk, std::memory_order_relaxed); begin < job.count;
+            begin = job.next.fetch_add(job.chunk, std::memory_order_relaxed)) {
+            job.run(job.context, begin, std::min(begin + job.chunk, job.count));
+        }
+    }
+
+    void retire(Job* job) {
+        auto it = std::find(jobs.begin(), jobs.end(), job);
+        if (it != jobs.end()) {
+            jobs.erase(it);
+        }
+    }
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            Job* job = jobs.front();
+            ++job->users;
+            lock.unlock();
+            runChunks(*job);
+            lock.lock();
+            retire(job); // every chunk is claimed, nobody else should pick it up
+            if (--job->users == 0) {
+                finished.notify_all();
+            }
+        }
+    }
+
+public:
+    explicit NotifyPool(unsigned threads) {
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~NotifyPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    NotifyPool(const NotifyPool&) = delete;
+    NotifyPool& operator=(const NotifyPool&) = delete;
+
+    size_t threadCount() const {
+        return workers.size();
+    }
+
+    // Calls body(begin, end) for consecutive chunks of [0, count) and returns
+    // once all of them have run
+    template <typename Body>
+    void parallelFor(size_t count, size_t chunk, Body& body) {
+        Job job;
+        job.run = [](void* context, size_t begin, size_t end) { (*static_cast<Body*>(context))(begin, end); };
+        job.context = &body;
+        job.count = count;
+        job.chunk = chunk;
+        bool shared = !workers.empty() && count > chunk;
+        if (shared) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                jobs.push_back(&job);
+            }
+            wake.notify_all();
+        }
+        runChunks(job);
+        if (shared) {
+            // The job lives on this stack: wait until no worker can touch it
+            std::unique_lock<std::mutex> lock(mutex);
+            retire(&job);
+            finished.wait(lock, [&job]() { return job.users == 0; });
+        }
+    }
+};
+
+inline unsigned defaultNotifyThreads() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+// Returned by subscribe and used to unsubscribe. A handle whose subscription
+// was already removed is stale: its generation no longer matches the slot's.
+// Slot generations skip 0, so a SubscriptionHandle that was never assigned
+// from subscribe cannot cancel the subscriber living in slot 0.
+struct SubscriptionHandle {
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+};
 
 // Publisher class
 class Publisher {
-    std::vector<Subscriber*> subscribers;
+    // The pointer is cleared when a subscriber is removed mid-publish, which
+    // notify threads may be reading at the same time
+    struct Entry {
+        std::atomic<Subscriber*> subscriber;
+        uint32_t slot;
+
+        Entry(Subscriber* subscriber, uint32_t slot) : subscriber(subscriber), slot(slot) {}
+        Entry(Entry&& other) noexcept
+            : subscriber(other.subscriber.load(std::memory_order_relaxed)), slot(other.slot) {}
+        Entry& operator=(Entry&& other) noexcept {
+            subscriber.store(other.subscriber.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            slot = other.slot;
+            return *this;
+        }
+    };
+
+    struct Slot {
+        uint32_t index;      // position in subscribers, or in pendingAdds while pending
+        uint32_t generation; // bumped on every unsubscribe, never 0
+        bool pending;
+    };
+
+    // Chunk of subscribers notified by one thread at a time
+    static constexpr size_t ChunkSize = 8192;
+
+    // Subscribers in a dense array, addressed through a slot map so a handle
+    // finds its entry in O(1) and removal is a swap with the last element.
+    // Changes made while a publish is running are applied when the last one
+    // returns, so the array never moves under the notify threads.
+    std::vector<Entry> subscribers;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<Entry> pendingAdds;
+    std::vector<uint32_t> pendingRemovals;
+    size_t liveCount = 0;
+    int publishing = 0;
+    uint64_t publishesFinished = 0; // bumped whenever publishing drops to zero
+    std::mutex mutex;
+    std::condition_variable idle;
+    NotifyPool pool;
+
+    void removeEntry(uint32_t slot) {
+        uint32_t index = slots[slot].index;
+        if (index != static_cast<uint32_t>(subscribers.size()) - 1) {
+            subscribers[index] = std::move(subscribers.back());
+            slots[subscribers[index].slot].index = index;
+        }
+        subscribers.pop_back();
+        freeSlots.push_back(slot);
+    }
+
+    void applyPending() {
+        for (uint32_t slot : pendingRemovals) {
+            removeEntry(slot);
+        }
+        pendingRemovals.clear();
+        for (auto& entry : pendingAdds) {
+            if (entry.subscriber.load(std::memory_order_relaxed) != nullptr) {
+                slots[entry.slot] = Slot{ static_cast<uint32_t>(subscribers.size()), slots[entry.slot].generation, false };
+                subscribers.push_back(std::move(entry));
+            }
+        }
+        pendingAdds.clear();
+    }
 
 public:
-    void subscribe(Subscriber* subscriber) {
-        subscribers.push_back(subscriber);
+    explicit Publisher(unsigned notifyThreads = defaultNotifyThreads()) : pool(notifyThreads) {}
+
+    Publisher(const Publisher&) = delete;
+    Publisher& operator=(const Publisher&) = delete;
+
+    SubscriptionHandle subscribe(Subscriber* subscriber) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot{ 0, 1, false });
+        }
+        if (publishing > 0) {
+            // Appending now could reallocate the array being notified
+            slots[slot].index = static_cast<uint32_t>(pendingAdds.size());
+            slots[slot].pending = true;
+            pendingAdds.emplace_back(subscriber, slot);
+        }
+        else {
+            slots[slot].index = static_cast<uint32_t>(subscribers.size());
+            slots[slot].pending = false;
+            subscribers.emplace_back(subscriber, slot);
+        }
+        ++liveCount;
+        return SubscriptionHandle{ slot, slots[slot].generation };
     }
 
-    void unsubscribe(Subscriber* subscriber) {
-        // Find and remove the subscriber from the list
-        auto it = std::find(subscribers.begin(), subscribers.end(), subscriber);
-        if (it != subscribers.end()) {
-            subscribers.erase(it);
+    // Remove the subscriber in O(1); returns false if the handle is stale.
+    // Safe from any thread, including inside receiveEvent during a publish:
+    // the subscriber is skipped from then on, though a notification already
+    // under way may still finish. Call waitForPublishes before destroying it.
+    bool unsubscribe(SubscriptionHandle handle) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation) {
+            return false;
+        }
+        Slot& slot = slots[handle.slot];
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        --liveCount;
+        if (slot.pending) {
+            pendingAdds[slot.index].subscriber.store(nullptr, std::memory_order_relaxed);
+            freeSlots.push_back(handle.slot);
         }
+        else if (publishing == 0) {
+            removeEntry(handle.slot);
+        }
+        else {
+            subscribers[slot.index].subscriber.store(nullptr, std::memory_order_release);
+            pendingRemovals.push_back(handle.slot);
+        }
+        return true;
     }
 
     void publishEvent(const std::string& event) {
-        // Notify all subscribers about the event
-        for (auto subscriber : subscribers) {
-            subscriber->receiveEvent(event);
+        Entry* entries;
+        size_t count;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++publishing;
+            entries = subscribers.data();
+            count = subscribers.size();
         }
+
+        // Notify all subscribers about the event, a chunk per thread at a time
+        auto notify = [entries, &event](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (Subscriber* subscriber = entries[i].subscriber.load(std::memory_order_acquire)) {
+                    subscriber->receiveEvent(event);
+                }
+            }
+        };
+        pool.parallelFor(count, ChunkSize, notify);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--publishing == 0) {
+            applyPending();
+            ++publishesFinished;
+            idle.notify_all();
+        }
+    }
+
+    // Blocks until the publishes running at the time of the call have
+    // returned, after which a subscriber unsubscribed beforehand can be
+    // destroyed. With publishes overlapping back to back this waits for the
+    // next moment none is running. Must not be called from receiveEvent.
+    void waitForPublishes() {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (publishing == 0) {
+            return;
+        }
+        uint64_t seen = publishesFinished;
+        idle.wait(lock, [this, seen]() { return publishesFinished != seen; });
+    }
+
+    size_t subscriberCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return liveCount;
+    }
+
+    size_t notifyThreads() const {
+        return pool.threadCount();
     }
 };
 
-// Subscriber class
-class Subscriber {
-    std::string name;
+// Removes itself from the publisher the first time it is notified
+class OneShotSubscriber : public Subscriber {
+    Publisher& publisher;
 
 public:
-    explicit Subscriber(const std::string& name) : name(name) {}
+    SubscriptionHandle handle;
 
-    void receiveEvent(const std::string& event) {
-        std::cout << "Subscriber " << name << " received event: " << event << std::endl;
+    OneShotSubscriber(const std::string& name, Publisher& publisher) : Subscriber(name), publisher(publisher) {}
+
+    void receiveEvent(const std::string& event) override {
+        Subscriber::receiveEvent(event);
+        publisher.unsubscribe(handle);
     }
 };
 
+class CountingSubscriber : public Subscriber {
+public:
+    uint64_t received = 0; // each subscriber is notified by one thread per publish
+
+    CountingSubscriber() : Subscriber("") {}
+
+    void receiveEvent(const std::string&) override {
+        ++received;
+    }
+};
+
+// Publish latency against the number of subscribers, notifying on the calling
+// thread alone and split across the pool, plus the cost of subscription churn
+void benchmarkFanOut() {
+    using Clock = std::chrono::steady_clock;
+    const std::string event = "tick";
+    Publisher serial(0);
+    Publisher pooled;
+    std::cout << "Notify threads: " << pooled.notifyThreads() << " plus the publishing thread" << std::endl;
+
+    for (size_t count : { size_t(1000), size_t(10000), size_t(100000), size_t(1000000) }) {
+        std::vector<CountingSubscriber> subscribers(count);
+        std::vector<SubscriptionHandle> serialHandles;
+        std::vector<SubscriptionHandle> pooledHandles;
+        serialHandles.reserve(count);
+        pooledHandles.reserve(count);
+        auto begin = Clock::now();
+        for (auto& subscriber : subscribers) {
+            serialHandles.push_back(serial.subscribe(&subscriber));
+        }
+        std::chrono::duration<double, std::nano> subscribeTime = Clock::now() - begin;
+        for (auto& subscriber : subscribers) {
+            pooledHandles.push_back(pooled.subscribe(&subscriber));
+        }
+
+        const int publishes = static_cast<int>(std::max<size_t>(10, 2000000 / count));
+        auto measure = [&](Publisher& publisher) {
+            double worst = 0;
+            auto start = Clock::now();
+            for (int i = 0; i < publishes; ++i) {
+                auto before = Clock::now();
+                publisher.publishEvent(event);
+                worst = std::max(worst, std::chrono::duration<double, std::micro>(Clock::now() - before).count());
+            }
+            double mean = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / publishes;
+            return std::make_pair(mean, worst);
+        };
+        auto [serialMean, serialWorst] = measure(serial);
+        auto [pooledMean, pooledWorst] = measure(pooled);
+
+        // Replace a random tenth of the subscriptions
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<size_t> pick(0, count - 1);
+        begin = Clock::now();
+        for (size_t i = 0; i < count / 10; ++i) {
+            size_t index = pick(rng);
+            serial.unsubscribe(serialHandles[index]);
+            serialHandles[index] = serial.subscribe(&subscribers[index]);
+        }
+        std::chrono::duration<double, std::nano> churnTime = Clock::now() - begin;
+
+        uint64_t received = 0;
+        for (const auto& subscriber : subscribers) {
+            received += subscriber.received;
+        }
+        std::cout << count << " subscribers: publish " << serialMean << " us (max " << serialWorst
+            << ") serial, " << pooledMean << " us (max " << pooledWorst << ") pooled; "
+            << subscribeTime.count() / count << " ns per subscribe, " << churnTime.count() / (count / 10)
+            << " ns per unsubscribe+subscribe (" << received << " notifications)" << std::endl;
+
+        for (size_t i = 0; i < count; ++i) {
+            serial.unsubscribe(serialHandles[i]);
+            pooled.unsubscribe(pooledHandles[i]);
+        }
+    }
+}
+
 int main() {
     // Create publisher and subscribers
     Publisher publisher;
@@ -48,19 +421,31 @@ int main() {
     Subscriber subscriber2("Subscriber 2");
     Subscriber subscriber3("Subscriber 3");
 
-    // Subscribe subscribers to the publisher
+    // Subscribe subscribers to the publisher, keeping the handles to unsubscribe later
     publisher.subscribe(&subscriber1);
-    publisher.subscribe(&subscriber2);
+    SubscriptionHandle handle2 = publisher.subscribe(&subscriber2);
     publisher.subscribe(&subscriber3);
 
     // Publish an event
     publisher.publishEvent("New event!");
 
     // Unsubscribe one subscriber
-    publisher.unsubscribe(&subscriber2);
+    publisher.unsubscribe(handle2);
 
     // Publish another event
     publisher.publishEvent("Another event!");
 
+    // A stale handle is rejected
+    std::cout << "Unsubscribing twice: " << (publisher.unsubscribe(handle2) ? "removed" : "stale handle") << std::endl;
+
+    // A subscriber may unsubscribe itself while the event is being published
+    OneShotSubscriber oneShot("One-shot", publisher);
+    oneShot.handle = publisher.subscribe(&oneShot);
+    publisher.publishEvent("Third event!");
+    publisher.publishEvent("Fourth event!");
+    std::cout << "Subscribers: " << publisher.subscriberCount() << std::endl;
+
+    benchmarkFanOut();
+
     return 0;
 }
@@ -8,13 +8,122 @@
 #include <sstream>
 #include <typeinfo>
 #include <stdexcept>
+#include <iterator>
+#include <thread>
+#include <future>
+#include <charconv>
+#include <string_view>
+#include <limits>
+#include <type_traits>
+#include <chrono>
 
 template<typename T>
 class Dictionary {
 private:
     std::unordered_map<std::string, std::any> data;
 
+    // Borrow the stored value without copying it out of the std::any
+    static const T& value_of(const std::pair<const std::string, std::any>& pair) {
+        const T* value = std::any_cast<T>(&pair.second);
+        if (!value) {
+            throw std::runtime_error("Type mismatch for key: " + pair.first);
+        }
+        return *value;
+    }
+
+    // Split the bucket array into contiguous ranges and run func(first, last)
+    // on each range in its own thread. Results are collected in range order.
+    template<typename Func>
+    auto run_chunked(Func func, size_t thread_count) const {
+        using Result = decltype(func(size_t{}, size_t{}));
+        size_t buckets = data.bucket_count();
+        size_t chunks = std::max<size_t>(1, std::min(thread_count, buckets));
+        size_t chunk_size = (buckets + chunks - 1) / chunks;
+
+        std::vector<std::future<Result>> futures;
+        futures.reserve(chunks);
+        for (size_t first = 0; first < buckets; first += chunk_size) {
+            size_t last = std::min(first + chunk_size, buckets);
+            futures.push_back(std::async(std::launch::async, func, first, last));
+        }
+
+        std::vector<Result> results;
+        results.reserve(futures.size());
+        for (auto& future : futures) {
+            results.push_back(future.get());
+        }
+        return results;
+    }
+
+    static size_t default_thread_count() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+public:
+    // Read-only iterator yielding (key, value) references with no copies.
+    // operator* returns the pair by value, which only an input iterator may
+    // do, so it is declared as one.
+    class const_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::pair<const std::string&, const T&>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        const_iterator() = default;
+        explicit const_iterator(typename std::unordered_map<std::string, std::any>::const_iterator it) : it(it) {}
+
+        reference operator*() const { return { it->first, value_of(*it) }; }
+        const_iterator& operator++() { ++it; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++it; return tmp; }
+        bool operator==(const const_iterator& other) const { return it == other.it; }
+        bool operator!=(const const_iterator& other) const { return it != other.it; }
+
+    private:
+        typename std::unordered_map<std::string, std::any>::const_iterator it;
+    };
+
+    // Lightweight range over one side of the entries (keys or values)
+    template<typename Ref, Ref(*Project)(const typename const_iterator::value_type&)>
+    class ProjectedView {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::decay_t<Ref>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Ref;
+
+            explicit iterator(const_iterator it) : it(it) {}
+            Ref operator*() const { return Project(*it); }
+            iterator& operator++() { ++it; return *this; }
+            iterator operator++(int) { iterator tmp = *this; ++it; return tmp; }
+            bool operator==(const iterator& other) const { return it == other.it; }
+            bool operator!=(const iterator& other) const { return it != other.it; }
+
+        private:
+            const_iterator it;
+        };
+
+        ProjectedView(const_iterator first, const_iterator last) : first(first), last(last) {}
+        iterator begin() const { return iterator(first); }
+        iterator end() const { return iterator(last); }
+
+    private:
+        const_iterator first, last;
+    };
+
+private:
+    static const std::string& project_key(const typename const_iterator::value_type& entry) { return entry.first; }
+    static const T& project_value(const typename const_iterator::value_type& entry) { return entry.second; }
+
 public:
+
+    using KeyView = ProjectedView<const std::string&, &Dictionary::project_key>;
+    using ValueView = ProjectedView<const T&, &Dictionary::project_value>;
+
     // Constructor
     Dictionary() = default;
 
@@ -94,16 +203,30 @@ public:
         std::vector<T> values;
         values.reserve(data.size());
         for (const auto& pair : data) {
-            try {
-                values.push_back(std::any_cast<T>(pair.second));
-            }
-            catch (const std::bad_any_cast&) {
-                throw std::runtime_error("Type mismatch for key: " + pair.first);
-            }
+            values.push_back(value_of(pair));
         }
         return values;
     }
 
+    // Iterate over (key, value) pairs without copying
+    const_iterator begin() const {
+        return const_iterator(data.begin());
+    }
+
+    const_iterator end() const {
+        return const_iterator(data.end());
+    }
+
+    // Iterate over keys without allocating a vector
+    KeyView keys_view() const {
+        return KeyView(begin(), end());
+    }
+
+    // Iterate over values without allocating a vector or copying values
+    ValueView values_view() const {
+        return ValueView(begin(), end());
+    }
+
     // Operator overload for accessing elements
     T& operator[](const std::string& key) {
         if (!contains_key(key)) {
@@ -124,12 +247,7 @@ public:
     // Apply a function to all key-value pairs
     void for_each(const std::function<void(const std::string&, const T&)>& func) const {
         for (const auto& pair : data) {
-            try {
-                func(pair.first, std::any_cast<T>(pair.second));
-            }
-            catch (const std::bad_any_cast&) {
-                throw std::runtime_error("Type mismatch for key: " + pair.first);
-            }
+            func(pair.first, value_of(pair));
         }
     }
 
@@ -137,45 +255,282 @@ public:
     std::vector<std::string> find_keys(const std::function<bool(const std::string&, const T&)>& predicate) const {
         std::vector<std::string> result;
         for (const auto& pair : data) {
-            try {
-                if (predicate(pair.first, std::any_cast<T>(pair.second))) {
-                    result.push_back(pair.first);
+            if (predicate(pair.first, value_of(pair))) {
+                result.push_back(pair.first);
+            }
+        }
+        return result;
+    }
+
+    // Count entries that match a predicate
+    size_t count_if(const std::function<bool(const std::string&, const T&)>& predicate) const {
+        size_t matches = 0;
+        for (const auto& pair : data) {
+            matches += predicate(pair.first, value_of(pair)) ? 1 : 0;
+        }
+        return matches;
+    }
+
+    // Parallel for_each: the function must be safe to call from several threads
+    void parallel_for_each(const std::function<void(const std::string&, const T&)>& func,
+        size_t thread_count = default_thread_count()) const {
+        run_chunked([this, &func](size_t first, size_t last) {
+            for (size_t bucket = first; bucket < last; ++bucket) {
+                for (auto it = data.begin(bucket); it != data.end(bucket); ++it) {
+                    func(it->first, value_of(*it));
                 }
             }
-            catch (const std::bad_any_cast&) {
-                throw std::runtime_error("Type mismatch for key: " + pair.first);
+            return true;
+            }, thread_count);
+    }
+
+    // Parallel find_keys: the predicate must be safe to call from several threads
+    std::vector<std::string> parallel_find_keys(const std::function<bool(const std::string&, const T&)>& predicate,
+        size_t thread_count = default_thread_count()) const {
+        auto partials = run_chunked([this, &predicate](size_t first, size_t last) {
+            std::vector<const std::string*> matches;
+            for (size_t bucket = first; bucket < last; ++bucket) {
+                for (auto it = data.begin(bucket); it != data.end(bucket); ++it) {
+                    if (predicate(it->first, value_of(*it))) {
+                        matches.push_back(&it->first);
+                    }
+                }
+            }
+            return matches;
+            }, thread_count);
+
+        size_t total = 0;
+        for (const auto& partial : partials) {
+            total += partial.size();
+        }
+        std::vector<std::string> result;
+        result.reserve(total);
+        for (const auto& partial : partials) {
+            for (const std::string* key : partial) {
+                result.push_back(*key);
             }
         }
         return result;
     }
 
+    // Parallel count_if: the predicate must be safe to call from several threads
+    size_t parallel_count_if(const std::function<bool(const std::string&, const T&)>& predicate,
+        size_t thread_count = default_thread_count()) const {
+        auto partials = run_chunked([this, &predicate](size_t first, size_t last) {
+            size_t matches = 0;
+            for (size_t bucket = first; bucket < last; ++bucket) {
+                for (auto it = data.begin(bucket); it != data.end(bucket); ++it) {
+                    matches += predicate(it->first, value_of(*it)) ? 1 : 0;
+                }
+            }
+            return matches;
+            }, thread_count);
+
+        size_t total = 0;
+        for (size_t partial : partials) {
+            total += partial;
+        }
+        return total;
+    }
+
+    // Insert a range of (key, value) pairs, reserving capacity once.
+    // Pass move iterators to move keys and values in instead of copying them.
+    template<typename InputIt>
+    void insert_range(InputIt first, InputIt last) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<InputIt>::iterator_category>) {
+            data.reserve(data.size() + static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            auto&& entry = *first;
+            using Entry = decltype(entry);
+            data.insert_or_assign(std::get<0>(std::forward<Entry>(entry)), std::any(std::get<1>(std::forward<Entry>(entry))));
+        }
+    }
+
     // Merge with another Dictionary
     void merge(const Dictionary& other) {
+        data.reserve(data.size() + other.data.size());
         for (const auto& pair : other.data) {
             data[pair.first] = pair.second;
         }
     }
 
-    // Convert to string representation
+    // Merge with another Dictionary, moving its entries in
+    void merge(Dictionary&& other) {
+        if (this == &other) {
+            return;
+        }
+        data.reserve(data.size() + other.data.size());
+        while (!other.data.empty()) {
+            auto node = other.data.extract(other.data.begin());
+            auto it = data.find(node.key());
+            if (it != data.end()) {
+                it->second = std::move(node.mapped());
+            }
+            else {
+                data.insert(std::move(node));
+            }
+        }
+    }
+
+    // Convert to string representation: {key: value, key: value}.
+    // Backslash, ',' and ':' inside keys and text values are escaped with a
+    // backslash, so from_string can split on the separators.
     std::string to_string() const {
-        std::ostringstream oss;
-        oss << "{";
+        std::string out;
+        size_t size_hint = 2;
+        for (const auto& pair : data) {
+            size_hint += pair.first.size() + 4 + max_chars_hint;
+        }
+        out.reserve(size_hint);
+
+        out.push_back('{');
         bool first = true;
         for (const auto& pair : data) {
             if (!first) {
-                oss << ", ";
+                out.append(", ");
             }
-            oss << pair.first << ": ";
-            try {
-                oss << std::any_cast<T>(pair.second);
+            append_escaped(out, pair.first);
+            out.append(": ");
+            const T* value = std::any_cast<T>(&pair.second);
+            if (value) {
+                append_value(out, *value);
             }
-            catch (const std::bad_any_cast&) {
-                oss << "ERROR";
+            else {
+                out.append("ERROR");
             }
             first = false;
         }
-        oss << "}";
-        return oss.str();
+        out.push_back('}');
+        return out;
+    }
+
+    // Parse the output of to_string back into a Dictionary
+    static Dictionary from_string(std::string_view text) {
+        if (text.size() < 2 || text.front() != '{' || text.back() != '}') {
+            throw std::invalid_argument("Dictionary text must be enclosed in braces");
+        }
+        text = text.substr(1, text.size() - 2);
+
+        Dictionary result;
+        if (text.empty()) {
+            return result;
+        }
+        result.data.reserve(static_cast<size_t>(std::count(text.begin(), text.end(), ',')) + 1);
+
+        while (true) {
+            size_t key_end = find_separator(text, ": ");
+            if (key_end == std::string_view::npos) {
+                throw std::invalid_argument("Missing ': ' after key: " + std::string(text.substr(0, 32)));
+            }
+            std::string key = unescape(text.substr(0, key_end));
+            text.remove_prefix(key_end + 2);
+
+            size_t value_end = find_separator(text, ", ");
+            std::string_view value = text.substr(0, value_end);
+            if (value.find('\\') == std::string_view::npos) {
+                result.data.insert_or_assign(std::move(key), std::any(parse_value(value)));
+            }
+            else {
+                result.data.insert_or_assign(std::move(key), std::any(parse_value(unescape(value))));
+            }
+
+            if (value_end == std::string_view::npos) {
+                break;
+            }
+            text.remove_prefix(value_end + 2);
+        }
+        return result;
+    }
+
+private:
+    // Numbers go through std::to_chars/std::from_chars; bool and character
+    // types keep their stream formatting, so they use the stream fallback
+    static constexpr bool uses_charconv =
+        std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+        !std::is_same_v<T, char> && !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char>;
+
+    static constexpr size_t max_chars_hint =
+        std::is_floating_point_v<T> ? 32 : (std::is_integral_v<T> ? std::numeric_limits<T>::digits10 + 3 : 16);
+
+    static void append_escaped(std::string& out, std::string_view text) {
+        if (text.find_first_of("\\,:") == std::string_view::npos) {
+            out.append(text);
+            return;
+        }
+        for (char c : text) {
+            if (c == '\\' || c == ',' || c == ':') {
+                out.push_back('\\');
+            }
+            out.push_back(c);
+        }
+    }
+
+    static std::string unescape(std::string_view text) {
+        std::string out;
+        out.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == '\\' && i + 1 < text.size()) {
+                ++i;
+            }
+            out.push_back(text[i]);
+        }
+        return out;
+    }
+
+    // First occurrence of separator whose leading character is not escaped
+    static size_t find_separator(std::string_view text, std::string_view separator) {
+        for (size_t pos = text.find(separator); pos != std::string_view::npos; pos = text.find(separator, pos + 1)) {
+            size_t backslashes = 0;
+            while (backslashes < pos && text[pos - backslashes - 1] == '\\') {
+                ++backslashes;
+            }
+            if (backslashes % 2 == 0) {
+                return pos;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    static void append_value(std::string& out, const T& value) {
+        if constexpr (uses_charconv) {
+            char buffer[64];
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, end);
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            append_escaped(out, std::string_view(value));
+        }
+        else {
+            std::ostringstream oss;
+            oss << value;
+            append_escaped(out, oss.str());
+        }
+    }
+
+    static T parse_value(std::string_view text) {
+        if constexpr (uses_charconv) {
+            T value{};
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (ec != std::errc() || end != text.data() + text.size()) {
+                throw std::invalid_argument("Invalid value: " + std::string(text));
+            }
+            return value;
+        }
+        else if constexpr (std::is_constructible_v<T, std::string_view>) {
+            return T(text);
+        }
+        else {
+            // noskipws so a value that formats with spaces, such as the char
+            // ' ', reads back unchanged; the whole field must be consumed
+            T value{};
+            std::istringstream iss{ std::string(text) };
+            if (!(iss >> std::noskipws >> value) || iss.peek() != std::char_traits<char>::eof()) {
+                throw std::invalid_argument("Invalid value: " + std::string(text));
+            }
+            return value;
+        }
     }
 };
 
@@ -221,9 +576,78 @@ int main() {
     dict2.add("four", 4);
     dict2.add("five", 5);
     dict2.add("six", 6);
-    dict.merge(dict2);
+    dict.merge(std::move(dict2));
 
     std::cout << "Merged dictionary: " << dict.to_string() << std::endl;
 
+    std::cout << "Entries (zero-copy): ";
+    for (const auto& [key, value] : dict) {
+        std::cout << key << "=" << value << " ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "Values (zero-copy): ";
+    for (const int& value : dict.values_view()) {
+        std::cout << value << " ";
+    }
+    std::cout << std::endl;
+
+    Dictionary<int> big;
+    std::vector<std::pair<std::string, int>> items;
+    for (int i = 0; i < 100000; ++i) {
+        items.emplace_back("key" + std::to_string(i), i);
+    }
+    big.insert_range(std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()));
+
+    auto divisible_by_7 = [](const std::string&, const int& value) { return value % 7 == 0; };
+    std::cout << "Divisible by 7 (serial): " << big.count_if(divisible_by_7) << std::endl;
+    std::cout << "Divisible by 7 (parallel): " << big.parallel_count_if(divisible_by_7) << std::endl;
+    std::cout << "Parallel find_keys matches: " << big.parallel_find_keys(divisible_by_7, 4).size() << std::endl;
+
+    Dictionary<int> parsed = Dictionary<int>::from_string(dict.to_string());
+    std::cout << "Parsed dictionary: " << parsed.to_string() << std::endl;
+
+    // Round-trip timing against the stream-based formatting this replaced
+    auto stream_to_string = [](const Dictionary<int>& d) {
+        std::ostringstream oss;
+        oss << "{";
+        bool first = true;
+        for (const auto& [key, value] : d) {
+            if (!first) {
+                oss << ", ";
+            }
+            oss << key << ": " << value;
+            first = false;
+        }
+        oss << "}";
+        return oss.str();
+    };
+    auto stream_from_string = [](const std::string& text) {
+        Dictionary<int> d;
+        std::istringstream iss(text.substr(1, text.size() - 2));
+        std::string entry;
+        while (std::getline(iss, entry, ',')) {
+            std::istringstream entry_stream(entry);
+            std::string key;
+            int value;
+            entry_stream >> key >> value;
+            key.pop_back(); // trailing ':'
+            d.add(key, value);
+        }
+        return d;
+    };
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    size_t stream_count = stream_from_string(stream_to_string(big)).count();
+    auto stream_time = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    start = Clock::now();
+    size_t fast_count = Dictionary<int>::from_string(big.to_string()).count();
+    auto fast_time = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    std::cout << "Stream round-trip: " << stream_count << " entries in " << stream_time << " ms" << std::endl;
+    std::cout << "Charconv round-trip: " << fast_count << " entries in " << fast_time << " ms" << std::endl;
+
     return 0;
 }
\ No newline at end of file
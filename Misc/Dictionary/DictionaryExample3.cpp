@@ -0,0 +1,585 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <any>
+#include <vector>
+#include <functional>
+#include <fstream>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary snapshot layout shared by Dictionary::save and MappedDictionary:
+//
+//   SnapshotHeader
+//   uint32_t buckets[bucket_count]   open-addressing index, EmptyBucket if unused
+//   SnapshotEntry entries[entry_count]
+//   T values[entry_count]            aligned to SnapshotAlignment
+//   char keys[]                      all keys back to back, no terminators
+namespace snapshot {
+
+constexpr uint32_t Magic = 0x50534444; // "DDSP"
+constexpr uint32_t Version = 1;
+constexpr uint32_t EmptyBucket = 0xFFFFFFFFu;
+constexpr size_t SnapshotAlignment = 16;
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t value_size;
+    uint64_t bucket_count;
+    uint64_t entry_count;
+    uint64_t values_offset;
+    uint64_t keys_offset;
+};
+
+struct SnapshotEntry {
+    uint64_t hash;
+    uint64_t key_offset;
+    uint64_t key_length;
+};
+
+// FNV-1a, so the on-disk index does not depend on the standard library's std::hash
+inline uint64_t hash_key(std::string_view key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Overflow-checked arithmetic for offsets read from a file: returns false
+// instead of wrapping around
+inline bool checked_add(uint64_t a, uint64_t b, uint64_t& sum) {
+    sum = a + b;
+    return sum >= a;
+}
+
+inline bool checked_mul(uint64_t a, uint64_t b, uint64_t& product) {
+    if (a != 0 && b > UINT64_MAX / a) {
+        return false;
+    }
+    product = a * b;
+    return true;
+}
+
+// Make the finished file at temp_path durable and move it over path. The
+// data is flushed before the rename and the rename itself afterwards, so
+// after a crash or power loss path holds either the old snapshot or the
+// complete new one, never nothing and never a partial file.
+inline void replace_file(const std::string& temp_path, const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(temp_path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open snapshot for syncing: " + temp_path);
+    }
+    bool flushed = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    if (!flushed) {
+        throw std::runtime_error("Failed to sync snapshot: " + temp_path);
+    }
+    if (!MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        throw std::runtime_error("Failed to replace snapshot: " + path);
+    }
+#else
+    int fd = ::open(temp_path.c_str(), O_WRONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open snapshot for syncing: " + temp_path);
+    }
+    bool flushed = ::fsync(fd) == 0;
+    ::close(fd);
+    if (!flushed) {
+        throw std::runtime_error("Failed to sync snapshot: " + temp_path);
+    }
+    // rename replaces an existing target atomically
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to replace snapshot: " + path);
+    }
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int dir_fd = ::open(directory.c_str(), O_RDONLY);
+    if (dir_fd < 0) {
+        throw std::runtime_error("Cannot open snapshot directory: " + directory);
+    }
+    flushed = ::fsync(dir_fd) == 0;
+    ::close(dir_fd);
+    if (!flushed) {
+        throw std::runtime_error("Failed to sync snapshot directory: " + directory);
+    }
+#endif
+}
+
+// Write key/value pairs to path, going through a temporary file and
+// replace_file so an existing snapshot is only ever swapped for a whole one
+template<typename T>
+void write(const std::string& path, const std::vector<std::pair<std::string_view, const T*>>& items) {
+    static_assert(std::is_trivially_copyable_v<T>, "Snapshots require trivially copyable values");
+    static_assert(alignof(T) <= SnapshotAlignment, "Value alignment exceeds snapshot alignment");
+
+    // Entry indices are stored as uint32_t, with EmptyBucket reserved
+    if (items.size() >= EmptyBucket) {
+        throw std::length_error("Too many entries for a snapshot: " + std::to_string(items.size()));
+    }
+
+    uint64_t bucket_count = 1;
+    while (bucket_count < items.size() * 2) {
+        bucket_count <<= 1;
+    }
+
+    SnapshotHeader header{};
+    header.magic = Magic;
+    header.version = Version;
+    header.value_size = sizeof(T);
+    header.bucket_count = bucket_count;
+    header.entry_count = items.size();
+    uint64_t entries_offset = sizeof(SnapshotHeader) + bucket_count * sizeof(uint32_t);
+    header.values_offset = align_up(entries_offset + items.size() * sizeof(SnapshotEntry), SnapshotAlignment);
+    header.keys_offset = header.values_offset + items.size() * sizeof(T);
+
+    std::vector<uint32_t> buckets(bucket_count, EmptyBucket);
+    std::vector<SnapshotEntry> entries;
+    entries.reserve(items.size());
+    uint64_t key_offset = 0;
+    for (const auto& [key, value] : items) {
+        SnapshotEntry entry{ hash_key(key), key_offset, key.size() };
+        uint64_t bucket = entry.hash & (bucket_count - 1);
+        while (buckets[bucket] != EmptyBucket) {
+            bucket = (bucket + 1) & (bucket_count - 1);
+        }
+        buckets[bucket] = static_cast<uint32_t>(entries.size());
+        entries.push_back(entry);
+        key_offset += key.size();
+    }
+
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open snapshot for writing: " + temp_path);
+        }
+        const char padding[SnapshotAlignment] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(uint32_t));
+        out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SnapshotEntry));
+        out.write(padding, header.values_offset - (entries_offset + entries.size() * sizeof(SnapshotEntry)));
+        for (const auto& item : items) {
+            out.write(reinterpret_cast<const char*>(item.second), sizeof(T));
+        }
+        for (const auto& item : items) {
+            out.write(item.first.data(), item.first.size());
+        }
+        if (!out) {
+            throw std::runtime_error("Failed to write snapshot: " + temp_path);
+        }
+    }
+    replace_file(temp_path, path);
+}
+
+// Read-only memory mapping of a whole file. Pages are loaded lazily by the OS.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open snapshot: " + path);
+        }
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file_, &file_size);
+        size_ = static_cast<size_t>(file_size.QuadPart);
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            void* view = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (!view) {
+                release();
+                throw std::runtime_error("Cannot map snapshot: " + path);
+            }
+            data_ = static_cast<const char*>(view);
+        }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open snapshot: " + path);
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat snapshot: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* view = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map snapshot: " + path);
+            }
+            data_ = static_cast<const char*>(view);
+        }
+        // The mapping keeps the file contents alive, the descriptor is no longer needed
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+        release();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void release() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+        data_ = nullptr;
+    }
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+} // namespace snapshot
+
+template<typename T>
+class Dictionary {
+private:
+    std::unordered_map<std::string, std::any> data;
+
+public:
+    // Add or update an item
+    void add(const std::string& key, const T& value) {
+        data[key] = value;
+    }
+
+    // Remove an item
+    bool remove(const std::string& key) {
+        return data.erase(key) > 0;
+    }
+
+    // Get value by key
+    T get(const std::string& key) const {
+        auto it = data.find(key);
+        if (it != data.end()) {
+            try {
+                return std::any_cast<T>(it->second);
+            }
+            catch (const std::bad_any_cast&) {
+                throw std::runtime_error("Type mismatch for key: " + key);
+            }
+        }
+        throw std::out_of_range("Key not found: " + key);
+    }
+
+    // Check if key exists
+    bool contains_key(const std::string& key) const {
+        return data.find(key) != data.end();
+    }
+
+    // Get number of items
+    size_t count() const {
+        return data.size();
+    }
+
+    // Clear all items
+    void clear() {
+        data.clear();
+    }
+
+    // Apply a function to all key-value pairs
+    void for_each(const std::function<void(const std::string&, const T&)>& func) const {
+        for (const auto& pair : data) {
+            const T* value = std::any_cast<T>(&pair.second);
+            if (!value) {
+                throw std::runtime_error("Type mismatch for key: " + pair.first);
+            }
+            func(pair.first, *value);
+        }
+    }
+
+    // Write a binary snapshot that MappedDictionary can serve lookups from
+    void save(const std::string& path) const {
+        std::vector<std::pair<std::string_view, const T*>> items;
+        items.reserve(data.size());
+        for_each([&items](const std::string& key, const T& value) {
+            items.emplace_back(key, &value);
+            });
+        snapshot::write<T>(path, items);
+    }
+};
+
+// Dictionary backed by a memory-mapped snapshot. Lookups read keys and values
+// straight out of the mapped image with no copy; writes go to a copy-on-write
+// overlay, and removed snapshot keys are remembered as tombstones.
+template<typename T>
+class MappedDictionary {
+private:
+    static_assert(std::is_trivially_copyable_v<T>, "Snapshots require trivially copyable values");
+
+    snapshot::MappedFile file;
+    const snapshot::SnapshotHeader* header = nullptr;
+    const uint32_t* buckets = nullptr;
+    const snapshot::SnapshotEntry* entries = nullptr;
+    const T* mapped_values = nullptr;
+    const char* mapped_keys = nullptr;
+
+    std::unordered_map<std::string, std::any> overlay;
+    std::unordered_set<std::string> tombstones;
+    size_t shadowed = 0; // overlay keys that also exist in the snapshot
+
+    std::string_view mapped_key(uint64_t index) const {
+        return { mapped_keys + entries[index].key_offset, entries[index].key_length };
+    }
+
+    // Index of the snapshot entry for key, or entry_count if there is none
+    uint64_t find_index(std::string_view key) const {
+        if (header->entry_count == 0) {
+            return header->entry_count;
+        }
+        uint64_t hash = snapshot::hash_key(key);
+        uint64_t mask = header->bucket_count - 1;
+        for (uint64_t bucket = hash & mask; buckets[bucket] != snapshot::EmptyBucket; bucket = (bucket + 1) & mask) {
+            uint32_t index = buckets[bucket];
+            if (entries[index].hash == hash && mapped_key(index) == key) {
+                return index;
+            }
+        }
+        return header->entry_count;
+    }
+
+    const T* find_mapped(std::string_view key) const {
+        uint64_t index = find_index(key);
+        return index < header->entry_count ? &mapped_values[index] : nullptr;
+    }
+
+    // Check the whole layout before anything is read through the mapping, so
+    // a corrupt or truncated file is rejected instead of read out of bounds
+    void validate(const std::string& path) const {
+        using snapshot::checked_add;
+        using snapshot::checked_mul;
+        uint64_t size = file.size();
+        if (size < sizeof(snapshot::SnapshotHeader)) {
+            throw std::runtime_error("Snapshot too small: " + path);
+        }
+        if (header->magic != snapshot::Magic || header->version != snapshot::Version) {
+            throw std::runtime_error("Not a dictionary snapshot: " + path);
+        }
+        if (header->value_size != sizeof(T)) {
+            throw std::runtime_error("Snapshot value size mismatch: " + path);
+        }
+
+        uint64_t bucket_count = header->bucket_count;
+        uint64_t entry_count = header->entry_count;
+        // At least one empty bucket, so every probe sequence terminates
+        if (bucket_count == 0 || (bucket_count & (bucket_count - 1)) != 0
+            || entry_count >= snapshot::EmptyBucket || (entry_count > 0 && bucket_count <= entry_count)) {
+            throw std::runtime_error("Snapshot index corrupt: " + path);
+        }
+        uint64_t bucket_bytes, entries_offset, entry_bytes, entries_end, value_bytes, values_end;
+        if (!checked_mul(bucket_count, sizeof(uint32_t), bucket_bytes)
+            || !checked_add(sizeof(snapshot::SnapshotHeader), bucket_bytes, entries_offset)
+            || !checked_mul(entry_count, sizeof(snapshot::SnapshotEntry), entry_bytes)
+            || !checked_add(entries_offset, entry_bytes, entries_end)
+            || !checked_mul(entry_count, sizeof(T), value_bytes)
+            || !checked_add(header->values_offset, value_bytes, values_end)
+            || entries_end > header->values_offset || header->values_offset % snapshot::SnapshotAlignment != 0
+            || values_end > header->keys_offset || header->keys_offset > size) {
+            throw std::runtime_error("Snapshot truncated: " + path);
+        }
+
+        const char* base = file.data();
+        const auto* index = reinterpret_cast<const uint32_t*>(base + sizeof(snapshot::SnapshotHeader));
+        uint64_t used = 0;
+        for (uint64_t bucket = 0; bucket < bucket_count; ++bucket) {
+            if (index[bucket] != snapshot::EmptyBucket && (index[bucket] >= entry_count || ++used > entry_count)) {
+                throw std::runtime_error("Snapshot index corrupt: " + path);
+            }
+        }
+        const auto* entry = reinterpret_cast<const snapshot::SnapshotEntry*>(base + entries_offset);
+        uint64_t keys_size = size - header->keys_offset;
+        for (uint64_t i = 0; i < entry_count; ++i) {
+            if (entry[i].key_offset > keys_size || entry[i].key_length > keys_size - entry[i].key_offset) {
+                throw std::runtime_error("Snapshot key out of range: " + path);
+            }
+        }
+    }
+
+public:
+    // Map a snapshot written by Dictionary::save or MappedDictionary::save
+    explicit MappedDictionary(const std::string& path) : file(path) {
+        const char* base = file.data();
+        header = reinterpret_cast<const snapshot::SnapshotHeader*>(base);
+        validate(path);
+        buckets = reinterpret_cast<const uint32_t*>(base + sizeof(snapshot::SnapshotHeader));
+        entries = reinterpret_cast<const snapshot::SnapshotEntry*>(buckets + header->bucket_count);
+        mapped_values = reinterpret_cast<const T*>(base + header->values_offset);
+        mapped_keys = base + header->keys_offset;
+    }
+
+    // Add or update an item (copy-on-write, the snapshot is never modified)
+    void add(const std::string& key, const T& value) {
+        auto [it, inserted] = overlay.insert_or_assign(key, value);
+        if (inserted && find_mapped(key)) {
+            ++shadowed;
+            tombstones.erase(key);
+        }
+    }
+
+    // Remove an item
+    bool remove(const std::string& key) {
+        bool in_snapshot = find_mapped(key) != nullptr;
+        if (overlay.erase(key) > 0) {
+            if (in_snapshot) {
+                --shadowed;
+                tombstones.insert(key);
+            }
+            return true;
+        }
+        return in_snapshot && tombstones.insert(key).second;
+    }
+
+    // Get a pointer to the value, or nullptr if the key is missing.
+    // Snapshot values are returned as pointers into the mapped file.
+    const T* find(const std::string& key) const {
+        auto it = overlay.find(key);
+        if (it != overlay.end()) {
+            return std::any_cast<T>(&it->second);
+        }
+        if (!tombstones.empty() && tombstones.count(key)) {
+            return nullptr;
+        }
+        return find_mapped(key);
+    }
+
+    // Get value by key
+    T get(const std::string& key) const {
+        if (const T* value = find(key)) {
+            return *value;
+        }
+        throw std::out_of_range("Key not found: " + key);
+    }
+
+    // Check if key exists
+    bool contains_key(const std::string& key) const {
+        return find(key) != nullptr;
+    }
+
+    // Get number of items
+    size_t count() const {
+        return header->entry_count - tombstones.size() - shadowed + overlay.size();
+    }
+
+    // Apply a function to all key-value pairs
+    void for_each(const std::function<void(const std::string_view&, const T&)>& func) const {
+        // Overlay keys and tombstones hide their snapshot entry. They are
+        // resolved to entry indices up front, so the pass over the snapshot
+        // compares indices instead of building a string per key.
+        std::vector<bool> hidden;
+        if (shadowed > 0 || !tombstones.empty()) {
+            hidden.resize(header->entry_count);
+            for (const auto& pair : overlay) {
+                uint64_t index = find_index(pair.first);
+                if (index < header->entry_count) {
+                    hidden[index] = true;
+                }
+            }
+            for (const auto& key : tombstones) {
+                hidden[find_index(key)] = true;
+            }
+        }
+        for (uint64_t i = 0; i < header->entry_count; ++i) {
+            if (hidden.empty() || !hidden[i]) {
+                func(mapped_key(i), mapped_values[i]);
+            }
+        }
+        for (const auto& pair : overlay) {
+            func(pair.first, *std::any_cast<T>(&pair.second));
+        }
+    }
+
+    // Write the merged view (snapshot plus overlay) as a new snapshot
+    void save(const std::string& path) const {
+        std::vector<std::pair<std::string_view, const T*>> items;
+        items.reserve(count());
+        for_each([&items](const std::string_view& key, const T& value) {
+            items.emplace_back(key, &value);
+            });
+        snapshot::write<T>(path, items);
+    }
+};
+
+struct Point {
+    double x, y;
+};
+
+// Example usage
+int main() {
+    try {
+        Dictionary<Point> dict;
+        for (int i = 0; i < 100000; ++i) {
+            dict.add("point" + std::to_string(i), Point{ i * 1.0, i * 2.0 });
+        }
+        dict.save("points.snapshot");
+        std::cout << "Saved " << dict.count() << " points" << std::endl;
+
+        MappedDictionary<Point> mapped("points.snapshot");
+        std::cout << "Mapped size: " << mapped.count() << std::endl;
+
+        Point p = mapped.get("point42");
+        std::cout << "Value for key 'point42': (" << p.x << ", " << p.y << ")" << std::endl;
+
+        // Writes land in the overlay, the mapped file is left untouched
+        mapped.add("point42", Point{ -1.0, -1.0 });
+        mapped.add("extra", Point{ 0.5, 0.5 });
+        mapped.remove("point7");
+
+        p = mapped.get("point42");
+        std::cout << "Updated 'point42': (" << p.x << ", " << p.y << ")" << std::endl;
+        std::cout << "Contains 'point7': " << (mapped.contains_key("point7") ? "true" : "false") << std::endl;
+        std::cout << "Contains 'extra': " << (mapped.contains_key("extra") ? "true" : "false") << std::endl;
+        std::cout << "Mapped size after writes: " << mapped.count() << std::endl;
+
+        mapped.save("points2.snapshot");
+        MappedDictionary<Point> reloaded("points2.snapshot");
+        std::cout << "Reloaded size: " << reloaded.count() << std::endl;
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Exception: " << ex.what() << std::endl;
+    }
+
+    std::remove("points.snapshot");
+    std::remove("points2.snapshot");
+
+    return 0;
+}
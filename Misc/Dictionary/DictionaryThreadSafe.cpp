@@ -0,0 +1,270 @@
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+// Thread-safe Dictionary that partitions its keys across independent shards.
+// Each shard has its own lock, so writers on different shards never contend,
+// and values are stored as immutable shared objects: a reader only holds the
+// shard lock long enough to copy a pointer and then reads the value lock-free.
+template<typename T>
+class ConcurrentDictionary {
+private:
+    using ValuePtr = std::shared_ptr<const T>;
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, ValuePtr> data;
+    };
+
+    std::vector<Shard> shards;
+    size_t shard_mask;
+
+    static size_t round_up_pow2(size_t n) {
+        size_t result = 1;
+        while (result < n) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    Shard& shard_for(const std::string& key) {
+        return shards[std::hash<std::string>{}(key) & shard_mask];
+    }
+
+    const Shard& shard_for(const std::string& key) const {
+        return shards[std::hash<std::string>{}(key) & shard_mask];
+    }
+
+    // Copy a shard's entries while holding its lock only for the copy, so the
+    // caller can run arbitrarily long work without blocking that shard's writers
+    static std::vector<std::pair<std::string, ValuePtr>> snapshot(const Shard& shard) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        return { shard.data.begin(), shard.data.end() };
+    }
+
+public:
+    // Constructor (shard count is rounded up to a power of two)
+    explicit ConcurrentDictionary(size_t shard_count = 4 * std::max(1u, std::thread::hardware_concurrency()))
+        : shards(round_up_pow2(std::max<size_t>(1, shard_count))), shard_mask(shards.size() - 1) {}
+
+    ConcurrentDictionary(const ConcurrentDictionary&) = delete;
+    ConcurrentDictionary& operator=(const ConcurrentDictionary&) = delete;
+
+    // Add or update an item
+    void add(const std::string& key, const T& value) {
+        add(key, std::make_shared<const T>(value));
+    }
+
+    // Add or update an item, taking ownership of the value
+    void add(const std::string& key, T&& value) {
+        add(key, std::make_shared<const T>(std::move(value)));
+    }
+
+    // Add or update an item with an already shared value
+    void add(const std::string& key, ValuePtr value) {
+        Shard& shard = shard_for(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.data[key] = std::move(value);
+    }
+
+    // Remove an item
+    bool remove(const std::string& key) {
+        Shard& shard = shard_for(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.data.erase(key) > 0;
+    }
+
+    // Get a shared handle to the value, or nullptr if the key is missing.
+    // The handle stays valid even if the key is updated or removed afterwards.
+    ValuePtr find(const std::string& key) const {
+        const Shard& shard = shard_for(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.data.find(key);
+        return it != shard.data.end() ? it->second : nullptr;
+    }
+
+    // Get value by key
+    T get(const std::string& key) const {
+        if (ValuePtr value = find(key)) {
+            return *value;
+        }
+        throw std::out_of_range("Key not found: " + key);
+    }
+
+    // Check if key exists
+    bool contains_key(const std::string& key) const {
+        const Shard& shard = shard_for(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.data.find(key) != shard.data.end();
+    }
+
+    // Get number of items (not a consistent snapshot while writers are active)
+    size_t count() const {
+        size_t total = 0;
+        for (const auto& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            total += shard.data.size();
+        }
+        return total;
+    }
+
+    // Get number of shards
+    size_t shard_count() const {
+        return shards.size();
+    }
+
+    // Clear all items
+    void clear() {
+        for (auto& shard : shards) {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.data.clear();
+        }
+    }
+
+    // Get all keys
+    std::vector<std::string> keys() const {
+        std::vector<std::string> keys;
+        for (const auto& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (const auto& pair : shard.data) {
+                keys.push_back(pair.first);
+            }
+        }
+        return keys;
+    }
+
+    // Get all values
+    std::vector<T> values() const {
+        std::vector<T> values;
+        for_each([&values](const std::string&, const T& value) {
+            values.push_back(value);
+            });
+        return values;
+    }
+
+    // Apply a function to all key-value pairs, one shard at a time
+    void for_each(const std::function<void(const std::string&, const T&)>& func) const {
+        for (const auto& shard : shards) {
+            for (const auto& [key, value] : snapshot(shard)) {
+                func(key, *value);
+            }
+        }
+    }
+
+    // Find keys that match a predicate, one shard at a time
+    std::vector<std::string> find_keys(const std::function<bool(const std::string&, const T&)>& predicate) const {
+        std::vector<std::string> result;
+        for_each([&](const std::string& key, const T& value) {
+            if (predicate(key, value)) {
+                result.push_back(key);
+            }
+            });
+        return result;
+    }
+
+    // Merge with another ConcurrentDictionary, one shard at a time.
+    // Values are immutable, so they are shared rather than copied.
+    void merge(const ConcurrentDictionary& other) {
+        if (this == &other) {
+            return;
+        }
+        for (const auto& other_shard : other.shards) {
+            auto entries = snapshot(other_shard);
+            if (shards.size() == other.shards.size()) {
+                // Same layout: every entry of this shard lands in the same target shard
+                if (entries.empty()) {
+                    continue;
+                }
+                Shard& shard = shard_for(entries.front().first);
+                std::unique_lock<std::shared_mutex> lock(shard.mutex);
+                for (auto& [key, value] : entries) {
+                    shard.data[key] = std::move(value);
+                }
+            }
+            else {
+                for (auto& [key, value] : entries) {
+                    add(key, std::move(value));
+                }
+            }
+        }
+    }
+
+    // Convert to string representation
+    std::string to_string() const {
+        std::ostringstream oss;
+        oss << "{";
+        bool first = true;
+        for_each([&](const std::string& key, const T& value) {
+            if (!first) {
+                oss << ", ";
+            }
+            oss << key << ": " << value;
+            first = false;
+            });
+        oss << "}";
+        return oss.str();
+    }
+};
+
+
+// Example usage
+int main() {
+    ConcurrentDictionary<int> dict(8);
+
+    const int writers = 4;
+    const int keys_per_writer = 1000;
+
+    // Writers fill disjoint key ranges while readers look keys up concurrently
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&dict, w] {
+            for (int i = 0; i < keys_per_writer; ++i) {
+                dict.add("key" + std::to_string(w * keys_per_writer + i), i);
+            }
+            });
+    }
+    for (int r = 0; r < 2; ++r) {
+        threads.emplace_back([&dict] {
+            size_t hits = 0;
+            for (int i = 0; i < writers * keys_per_writer; ++i) {
+                if (auto value = dict.find("key" + std::to_string(i))) {
+                    hits += (*value >= 0);
+                }
+            }
+            (void)hits;
+            });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::cout << "Shards: " << dict.shard_count() << std::endl;
+    std::cout << "Dictionary size: " << dict.count() << std::endl;
+    std::cout << "Value for key 'key1234': " << dict.get("key1234") << std::endl;
+
+    auto keys = dict.find_keys([](const std::string&, const int& value) {
+        return value == 999; // Last key written by each writer
+        });
+    std::cout << "Keys with value 999: " << keys.size() << std::endl;
+
+    ConcurrentDictionary<int> small(2);
+    small.add("one", 1);
+    small.add("two", 2);
+
+    ConcurrentDictionary<int> other(2);
+    other.add("three", 3);
+    small.merge(other);
+
+    std::cout << "Merged dictionary: " << small.to_string() << std::endl;
+
+    return 0;
+}
@@ -4,6 +4,13 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <chrono>
 
 // Forward declaration
 class EventHandler;
@@ -111,6 +118,193 @@ private:
     std::vector<std::unique_ptr<Event>> events_;
 };
 
+// Events that own no resources can be dropped by the frame arena without
+// running their destructor. Other event types still work, but each one
+// costs a destructor record that is run when its frame is reset.
+template<typename E>
+struct TriviallyReclaimable : std::false_type {};
+
+template<> struct TriviallyReclaimable<MouseClickEvent> : std::true_type {};
+template<> struct TriviallyReclaimable<KeyPressEvent> : std::true_type {};
+template<> struct TriviallyReclaimable<WindowResizeEvent> : std::true_type {};
+
+// Bump allocator for one frame's events. Memory is handed out by advancing
+// an offset through a list of chunks; reset() rewinds to the first chunk and
+// keeps every chunk, so a steady-state frame performs no heap allocation.
+class FrameArena {
+public:
+    explicit FrameArena(size_t chunk_size = 64 * 1024) : chunk_size_(chunk_size) {}
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment) {
+        while (current_ < chunks_.size()) {
+            Chunk& chunk = chunks_[current_];
+            uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data.get());
+            size_t aligned = static_cast<size_t>(((base + offset_ + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base);
+            if (aligned + size <= chunk.size) {
+                offset_ = aligned + size;
+                return chunk.data.get() + aligned;
+            }
+            ++current_;
+            offset_ = 0;
+        }
+        // Oversized requests get a chunk of their own
+        size_t chunk_size = std::max(chunk_size_, size + alignment);
+        chunks_.push_back(Chunk{ std::make_unique<std::byte[]>(chunk_size), chunk_size });
+        current_ = chunks_.size() - 1;
+        offset_ = 0;
+        return allocate(size, alignment);
+    }
+
+    // Forget every allocation at once
+    void reset() {
+        current_ = 0;
+        offset_ = 0;
+    }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const auto& chunk : chunks_) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks_;
+    size_t chunk_size_;
+    size_t current_ = 0;
+    size_t offset_ = 0;
+};
+
+// Double-buffered event queue for a frame-driven loop. Producers construct
+// events in the back buffer's arena while the dispatcher works through the
+// front buffer; swapBuffers() at the frame boundary exchanges the two, and
+// processEvents() dispatches the front batch and resets its arena in O(1).
+class FrameEventQueue {
+public:
+    FrameEventQueue() = default;
+    FrameEventQueue(const FrameEventQueue&) = delete;
+    FrameEventQueue& operator=(const FrameEventQueue&) = delete;
+
+    ~FrameEventQueue() {
+        std::lock_guard<std::mutex> lock(back_mutex_);
+        front_->clear();
+        back_->clear();
+    }
+
+    // Construct an event in the back buffer; it is dispatched next frame
+    template<typename E, typename... Args>
+    void emplaceEvent(Args&&... args) {
+        static_assert(std::is_base_of_v<Event, E>, "Frame events must derive from Event");
+        std::lock_guard<std::mutex> lock(back_mutex_);
+        back_->template emplace<E>(std::forward<Args>(args)...);
+    }
+
+    // Frame boundary: the events pushed so far become the batch to dispatch.
+    // Call from the dispatching thread after the previous batch is processed.
+    void swapBuffers() {
+        std::lock_guard<std::mutex> lock(back_mutex_);
+        std::swap(front_, back_);
+    }
+
+    // Dispatch the current batch in push order, then drop it
+    void processEvents(const EventHandler& handler) {
+        for (const Event* event : front_->events) {
+            handler.dispatchEvent(*event);
+        }
+        front_->clear();
+    }
+
+    size_t pendingEvents() const {
+        std::lock_guard<std::mutex> lock(back_mutex_);
+        return back_->events.size();
+    }
+
+private:
+    // Destructor record for events that are not TriviallyReclaimable,
+    // allocated in the same arena as the event
+    struct Finalizer {
+        void (*destroy)(Event*);
+        Event* event;
+        Finalizer* next;
+    };
+
+    struct Buffer {
+        FrameArena arena;
+        std::vector<Event*> events;
+        Finalizer* finalizers = nullptr;
+
+        template<typename E, typename... Args>
+        void emplace(Args&&... args) {
+            void* memory = arena.allocate(sizeof(E), alignof(E));
+            E* event = ::new (memory) E(std::forward<Args>(args)...);
+            if constexpr (!TriviallyReclaimable<E>::value) {
+                void* record = arena.allocate(sizeof(Finalizer), alignof(Finalizer));
+                finalizers = ::new (record) Finalizer{ [](Event* e) { static_cast<E*>(e)->~E(); }, event, finalizers };
+            }
+            events.push_back(event);
+        }
+
+        void clear() {
+            for (Finalizer* finalizer = finalizers; finalizer; finalizer = finalizer->next) {
+                finalizer->destroy(finalizer->event);
+            }
+            finalizers = nullptr;
+            events.clear(); // keeps its capacity for the next frame
+            arena.reset();
+        }
+    };
+
+    Buffer buffers_[2];
+    Buffer* front_ = &buffers_[0];
+    Buffer* back_ = &buffers_[1];
+    mutable std::mutex back_mutex_;
+};
+
+// Compare a frame of heap-allocated events with a frame built in the arena
+void benchmarkFrameQueue() {
+    const int frames = 100;
+    const int events_per_frame = 10000;
+
+    EventHandler handler;
+    long long sum = 0;
+    handler.registerCallback(Event::Type::MouseClick, [&sum](const Event& e) {
+        sum += static_cast<const MouseClickEvent&>(e).getX();
+        });
+
+    EventQueue heapQueue;
+    auto begin = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int i = 0; i < events_per_frame; ++i) {
+            heapQueue.pushEvent(std::make_unique<MouseClickEvent>(i, frame));
+        }
+        heapQueue.processEvents(handler);
+    }
+    std::chrono::duration<double, std::milli> heapTime = std::chrono::steady_clock::now() - begin;
+
+    FrameEventQueue frameQueue;
+    begin = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int i = 0; i < events_per_frame; ++i) {
+            frameQueue.emplaceEvent<MouseClickEvent>(i, frame);
+        }
+        frameQueue.swapBuffers();
+        frameQueue.processEvents(handler);
+    }
+    std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - begin;
+
+    std::cout << frames << " frames of " << events_per_frame << " events: unique_ptr queue "
+        << heapTime.count() << " ms, frame arena " << frameTime.count() << " ms (checksum " << sum << ")\n";
+}
+
 // Example usage
 int main() {
     EventHandler handler;
@@ -140,5 +334,21 @@ int main() {
     // Process events
     queue.processEvents(handler);
 
+    // Frame loop: events pushed during frame N are dispatched at the start of
+    // frame N + 1, after a single buffer swap
+    FrameEventQueue frameQueue;
+    for (int frame = 0; frame < 3; ++frame) {
+        frameQueue.swapBuffers();
+        frameQueue.processEvents(handler);
+
+        std::cout << "-- frame " << frame << "\n";
+        frameQueue.emplaceEvent<MouseClickEvent>(frame * 10, frame * 20);
+        frameQueue.emplaceEvent<KeyPressEvent>(static_cast<char>('A' + frame));
+    }
+    frameQueue.swapBuffers();
+    frameQueue.processEvents(handler);
+
+    benchmarkFrameQueue();
+
     return 0;
 }
\ No newline at end of file
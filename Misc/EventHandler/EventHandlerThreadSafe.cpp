@@ -6,10 +6,19 @@
 #include <algorithm>
 #include <mutex>
 #include <shared_mutex>
+#include <array>
+#include <cstring>
+#include <cstddef>
 #include <atomic>
 #include <thread>
 #include <condition_variable>
-#include <queue>
+#include <cstdint>
+#include <chrono>
+#include <variant>
+#include <string>
+#include <new>
+#include <type_traits>
+#include <stdexcept>
 
 class Event {
 public:
@@ -17,6 +26,7 @@ public:
         MouseClick,
         KeyPress,
         WindowResize,
+        MouseMove,
         Custom
     };
 
@@ -32,6 +42,8 @@ private:
 // Specialized event classes
 class MouseClickEvent : public Event {
 public:
+    static constexpr Type StaticType = Type::MouseClick;
+
     MouseClickEvent(int x, int y) : Event(Type::MouseClick), x_(x), y_(y) {}
     int getX() const { return x_; }
     int getY() const { return y_; }
@@ -42,6 +54,8 @@ private:
 
 class KeyPressEvent : public Event {
 public:
+    static constexpr Type StaticType = Type::KeyPress;
+
     explicit KeyPressEvent(char key) : Event(Type::KeyPress), key_(key) {}
     char getKey() const { return key_; }
 
@@ -51,6 +65,8 @@ private:
 
 class WindowResizeEvent : public Event {
 public:
+    static constexpr Type StaticType = Type::WindowResize;
+
     WindowResizeEvent(int width, int height) : Event(Type::WindowResize), width_(width), height_(height) {}
     int getWidth() const { return width_; }
     int getHeight() const { return height_; }
@@ -59,96 +75,1476 @@ private:
     int width_, height_;
 };
 
+class MouseMoveEvent : public Event {
+public:
+    static constexpr Type StaticType = Type::MouseMove;
+
+    MouseMoveEvent(int dx, int dy) : Event(Type::MouseMove), dx_(dx), dy_(dy) {}
+    int getDeltaX() const { return dx_; }
+    int getDeltaY() const { return dy_; }
+
+    // Fold a later move into this one, used when moves are coalesced
+    void accumulate(const MouseMoveEvent& other) {
+        dx_ += other.dx_;
+        dy_ += other.dy_;
+    }
+
+private:
+    int dx_, dy_;
+};
+
+// Custom event: not one of the built-in types, so queues store it in a pool block
+class TextInputEvent : public Event {
+public:
+    static constexpr Type StaticType = Type::Custom;
+
+    explicit TextInputEvent(std::string text) : Event(Type::Custom), text_(std::move(text)) {}
+    const std::string& getText() const { return text_; }
+
+private:
+    std::string text_;
+};
+
+constexpr size_t EventTypeCount = static_cast<size_t>(Event::Type::Custom) + 1;
+
+// Contiguous run of events of one type, handed to batch callbacks
+class EventSpan {
+public:
+    EventSpan(const Event* const* events, size_t count) : events_(events), count_(count) {}
+
+    const Event* const* begin() const { return events_; }
+    const Event* const* end() const { return events_ + count_; }
+    const Event& operator[](size_t index) const { return *events_[index]; }
+    size_t size() const { return count_; }
+
+private:
+    const Event* const* events_;
+    size_t count_;
+};
+
+// Fixed-memory latency histogram in the style of HdrHistogram: every power of
+// two is split into 16 linear sub-buckets, so any recorded value is reported
+// within about 6% using a few kilobytes no matter how many samples are taken.
+// Recording is meant for a single writer (a queue's worker); snapshot() may be
+// called from any thread at any time and only reads the counters.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SubBucketBits = 4;
+    static constexpr size_t SubBuckets = size_t(1) << SubBucketBits;
+    static constexpr unsigned MaxValueBits = 40; // ~18 minutes in nanoseconds
+    static constexpr size_t BucketCount = (MaxValueBits - SubBucketBits + 1) * SubBuckets;
+
+    // Plain copy of the counters; percentiles are computed from the copy
+    class Snapshot {
+    public:
+        uint64_t count() const { return count_; }
+        uint64_t max() const { return max_; }
+
+        double mean() const {
+            return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+        }
+
+        // Upper bound of the bucket holding the given percentile (0-100)
+        uint64_t percentile(double percent) const {
+            if (count_ == 0) {
+                return 0;
+            }
+            uint64_t rank = static_cast<uint64_t>(percent / 100.0 * static_cast<double>(count_) + 0.5);
+            rank = std::min<uint64_t>(std::max<uint64_t>(rank, 1), count_);
+            uint64_t seen = 0;
+            for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+                seen += counts_[bucket];
+                if (seen >= rank) {
+                    return std::min(upperBound(bucket), max_);
+                }
+            }
+            return max_;
+        }
+
+        // Combine with another snapshot, e.g. the same type from another shard
+        void merge(const Snapshot& other) {
+            for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+                counts_[bucket] += other.counts_[bucket];
+            }
+            count_ += other.count_;
+            sum_ += other.sum_;
+            max_ = std::max(max_, other.max_);
+        }
+
+    private:
+        friend class LatencyHistogram;
+
+        std::array<uint64_t, BucketCount> counts_{};
+        uint64_t count_ = 0;
+        uint64_t sum_ = 0;
+        uint64_t max_ = 0;
+    };
+
+    void record(uint64_t value) {
+        value = std::min(value, MaxValue);
+        bump(counts_[bucketIndex(value)], 1);
+        bump(sum_, value);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void record(std::chrono::nanoseconds duration) {
+        record(static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(0, duration.count())));
+    }
+
+    // Not an atomic cut across buckets, but every count is at most one
+    // in-flight sample off, which is fine for periodic monitoring
+    Snapshot snapshot() const {
+        Snapshot result;
+        for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+            result.counts_[bucket] = counts_[bucket].load(std::memory_order_relaxed);
+            result.count_ += result.counts_[bucket];
+        }
+        result.sum_ = sum_.load(std::memory_order_relaxed);
+        result.max_ = max_.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    static constexpr uint64_t MaxValue = (uint64_t(1) << MaxValueBits) - 1;
+
+    // Only the owning worker writes, so a relaxed load/store pair is enough
+    // and avoids a locked read-modify-write per sample
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static unsigned highestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < SubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        unsigned shift = highestBit(value) - SubBucketBits;
+        return (shift + 1) * SubBuckets + static_cast<size_t>((value >> shift) - SubBuckets);
+    }
+
+    static uint64_t upperBound(size_t bucket) {
+        size_t group = bucket / SubBuckets;
+        uint64_t sub = bucket % SubBuckets;
+        if (group == 0) {
+            return sub;
+        }
+        return ((SubBuckets + sub + 1) << (group - 1)) - 1;
+    }
+
+    std::array<std::atomic<uint64_t>, BucketCount> counts_{};
+    std::atomic<uint64_t> sum_{ 0 };
+    std::atomic<uint64_t> max_{ 0 };
+};
+
+using LatencyByType = std::array<LatencyHistogram, EventTypeCount>;
+
+// Callable wrapper for event callbacks. Callables of up to InlineSize bytes
+// (plain lambdas, bound member functions, a std::function) live inside the
+// delegate; only larger ones are copied to the heap. Calling it is a single
+// indirect call through a function pointer.
+class EventDelegate {
+public:
+    static constexpr size_t InlineSize = 4 * sizeof(void*);
+
+    EventDelegate() = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, EventDelegate>>>
+    explicit EventDelegate(F&& fn) {
+        using Fn = std::decay_t<F>;
+        if constexpr (sizeof(Fn) <= InlineSize && alignof(Fn) <= alignof(std::max_align_t)) {
+            ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(fn));
+            invoke_ = [](void* self, const Event& event) { (*static_cast<Fn*>(self))(event); };
+            destroy_ = [](void* self) { static_cast<Fn*>(self)->~Fn(); };
+        }
+        else {
+            Fn* heap = new Fn(std::forward<F>(fn));
+            std::memcpy(storage_, &heap, sizeof(heap));
+            invoke_ = [](void* self, const Event& event) { (**static_cast<Fn**>(self))(event); };
+            destroy_ = [](void* self) { delete *static_cast<Fn**>(self); };
+        }
+    }
+
+    ~EventDelegate() {
+        if (destroy_) {
+            destroy_(storage_);
+        }
+    }
+
+    EventDelegate(const EventDelegate&) = delete;
+    EventDelegate& operator=(const EventDelegate&) = delete;
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+    void operator()(const Event& event) const {
+        invoke_(const_cast<unsigned char*>(storage_), event);
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char storage_[InlineSize];
+    void (*invoke_)(void*, const Event&) = nullptr;
+    void (*destroy_)(void*) = nullptr;
+};
+
+// Event handler with lock-free dispatch. Callback lists are immutable
+// snapshots published through an atomic pointer: dispatchEvent only loads the
+// current snapshot, while registrations copy it, modify the copy and publish
+// it. Replaced snapshots are freed once no dispatch can still be reading them,
+// which is tracked with two sets of striped reader counters (see ReadGuard).
+// Each snapshot is a dense array indexed by Event::Type, so dispatch does no
+// hashing, and callbacks are EventDelegates rather than std::functions.
 class EventHandler {
 public:
     using EventCallback = std::function<void(const Event&)>;
+    using BatchCallback = std::function<void(EventSpan)>;
+    using CallbackToken = uint64_t;
 
-    void registerCallback(Event::Type type, EventCallback callback) {
-        std::unique_lock<std::shared_mutex> lock(mutex_);
-        callbacks_[type].push_back(std::move(callback));
+    EventHandler() : table_(new CallbackTable()) {}
+
+    ~EventHandler() {
+        delete table_.load();
+        for (const auto& retired : retired_) {
+            delete retired.table;
+        }
+    }
+
+    EventHandler(const EventHandler&) = delete;
+    EventHandler& operator=(const EventHandler&) = delete;
+
+    // Register a callback; the token can later be passed to unregisterCallback
+    CallbackToken registerCallback(Event::Type type, EventCallback callback) {
+        return subscribe(type, std::move(callback));
+    }
+
+    // Typed registration: fn receives the concrete event type, no cast needed.
+    // Custom is shared by every user-defined class, so for those fn only sees
+    // events that really are an E.
+    template<typename E, typename F>
+    CallbackToken on(F&& fn) {
+        return subscribe(E::StaticType, [fn = std::forward<F>(fn)](const Event& event) mutable {
+            if (const E* typed = downcast<E>(event)) {
+                fn(*typed);
+            }
+        });
+    }
+
+    // Typed registration of a member function. The handler does not own the
+    // object, which must outlive the subscription.
+    template<typename E, auto Method, typename Object>
+    CallbackToken on(Object* object) {
+        return subscribe(E::StaticType, [object](const Event& event) {
+            if (const E* typed = downcast<E>(event)) {
+                (object->*Method)(*typed);
+            }
+        });
+    }
+
+    // Register a callback that receives all events of one type from a
+    // dispatchBatch call at once, instead of one call per event
+    CallbackToken registerBatchCallback(Event::Type type, BatchCallback callback) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto subscription = std::make_shared<Subscription>(next_token_++, std::move(callback));
+        subscriptions_.emplace(subscription->token, subscription);
+
+        auto next = std::make_unique<CallbackTable>(*table_.load(std::memory_order_relaxed));
+        next->batch_lists[index(type)].push_back(subscription);
+        next->has_batch = true;
+        publish(std::move(next));
+        return subscription->token;
+    }
+
+    // O(1): the subscription is switched off in place and physically removed
+    // from the lists once enough dead entries have accumulated. A dispatch
+    // that is already running may still invoke it one last time.
+    bool unregisterCallback(CallbackToken token) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto it = subscriptions_.find(token);
+        if (it == subscriptions_.end()) {
+            return false;
+        }
+        it->second->active.store(false, std::memory_order_release);
+        subscriptions_.erase(it);
+        if (++inactive_ > subscriptions_.size()) {
+            purgeInactive();
+        }
+        return true;
     }
 
     void dispatchEvent(const Event& event) const {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
-        auto it = callbacks_.find(event.getType());
-        if (it != callbacks_.end()) {
-            for (const auto& callback : it->second) {
-                callback(event);
+        ReadGuard guard(*this);
+        const CallbackTable* table = table_.load(std::memory_order_seq_cst);
+        for (const auto& subscription : table->lists[index(event.getType())]) {
+            if (subscription->active.load(std::memory_order_acquire)) {
+                subscription->callback(event);
+            }
+        }
+    }
+
+    // Dispatch several events: per-event callbacks run in order, then every
+    // batch callback receives the events of its type as one span. If
+    // callback_time is given, the time spent in the callbacks of each event
+    // (and of each span handed to batch callbacks) is recorded per type.
+    void dispatchBatch(const std::vector<const Event*>& events, LatencyByType* callback_time = nullptr) const {
+        dispatchBatch(events, callback_time, [](size_t) {});
+    }
+
+    // As above, calling before_event(i) right before the per-event callbacks
+    // of events[i] run
+    template<typename BeforeEvent>
+    void dispatchBatch(const std::vector<const Event*>& events, LatencyByType* callback_time, BeforeEvent&& before_event) const {
+        ReadGuard guard(*this);
+        const CallbackTable* table = table_.load(std::memory_order_seq_cst);
+        for (size_t i = 0; i < events.size(); ++i) {
+            const Event* event = events[i];
+            before_event(i);
+            const auto& list = table->lists[index(event->getType())];
+            auto begin = callback_time && !list.empty() ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+            for (const auto& subscription : list) {
+                if (subscription->active.load(std::memory_order_acquire)) {
+                    subscription->callback(*event);
+                }
+            }
+            if (begin != std::chrono::steady_clock::time_point{}) {
+                (*callback_time)[index(event->getType())].record(std::chrono::steady_clock::now() - begin);
+            }
+        }
+        if (!table->has_batch) {
+            return;
+        }
+
+        // Bucket by type so each span keeps push order. The buckets are
+        // reused across calls on this thread, except by a callback that
+        // dispatches again while the outer call still reads them: that call
+        // gets buckets of its own.
+        using Buckets = std::array<std::vector<const Event*>, EventTypeCount>;
+        thread_local Buckets reusable;
+        thread_local bool reusable_in_use = false;
+        Buckets nested;
+        struct Lease {
+            Buckets& buckets;
+            bool owns_reusable;
+            ~Lease() {
+                for (auto& bucket : buckets) {
+                    bucket.clear();
+                }
+                if (owns_reusable) {
+                    reusable_in_use = false;
+                }
+            }
+        } lease{ reusable_in_use ? nested : reusable, !reusable_in_use };
+        reusable_in_use = true;
+        Buckets& by_type = lease.buckets;
+        for (const Event* event : events) {
+            by_type[index(event->getType())].push_back(event);
+        }
+        for (size_t type = 0; type < EventTypeCount; ++type) {
+            if (by_type[type].empty()) {
+                continue;
+            }
+            EventSpan span(by_type[type].data(), by_type[type].size());
+            auto begin = callback_time && !table->batch_lists[type].empty() ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+            for (const auto& subscription : table->batch_lists[type]) {
+                if (subscription->active.load(std::memory_order_acquire)) {
+                    subscription->batch_callback(span);
+                }
+            }
+            if (begin != std::chrono::steady_clock::time_point{}) {
+                (*callback_time)[type].record(std::chrono::steady_clock::now() - begin);
             }
         }
     }
 
     void clearCallbacks(Event::Type type) {
-        std::unique_lock<std::shared_mutex> lock(mutex_);
-        callbacks_.erase(type);
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto next = std::make_unique<CallbackTable>(*table_.load(std::memory_order_relaxed));
+        for (auto* lists : { &next->lists, &next->batch_lists }) {
+            for (const auto& subscription : (*lists)[index(type)]) {
+                subscription->active.store(false, std::memory_order_release);
+                subscriptions_.erase(subscription->token);
+            }
+            (*lists)[index(type)].clear();
+        }
+        publish(std::move(next));
     }
 
     void clearAllCallbacks() {
-        std::unique_lock<std::shared_mutex> lock(mutex_);
-        callbacks_.clear();
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        for (const auto& [token, subscription] : subscriptions_) {
+            subscription->active.store(false, std::memory_order_release);
+        }
+        subscriptions_.clear();
+        inactive_ = 0;
+        publish(std::make_unique<CallbackTable>());
     }
 
 private:
-    mutable std::shared_mutex mutex_;
-    std::unordered_map<Event::Type, std::vector<EventCallback>> callbacks_;
+    // A built-in type identifies its class, so the cast is free; Custom
+    // events are checked with a dynamic_cast
+    template<typename E>
+    static const E* downcast(const Event& event) {
+        static_assert(std::is_base_of_v<Event, E>, "Events must derive from Event");
+        if constexpr (E::StaticType == Event::Type::Custom) {
+            return dynamic_cast<const E*>(&event);
+        }
+        else {
+            return static_cast<const E*>(&event);
+        }
+    }
+
+    struct Subscription {
+        template<typename F>
+        Subscription(CallbackToken token, F&& callback)
+            : token(token), callback(std::forward<F>(callback)) {}
+
+        Subscription(CallbackToken token, BatchCallback callback)
+            : token(token), batch_callback(std::move(callback)) {}
+
+        CallbackToken token;
+        EventDelegate callback;
+        BatchCallback batch_callback;
+        std::atomic<bool> active{ true };
+    };
+
+    using SubscriptionLists = std::array<std::vector<std::shared_ptr<Subscription>>, EventTypeCount>;
+
+    struct CallbackTable {
+        SubscriptionLists lists;
+        SubscriptionLists batch_lists;
+        bool has_batch = false;
+    };
+
+    static size_t index(Event::Type type) {
+        return static_cast<size_t>(type);
+    }
+
+    template<typename F>
+    CallbackToken subscribe(Event::Type type, F&& callback) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto subscription = std::make_shared<Subscription>(next_token_++, std::forward<F>(callback));
+        subscriptions_.emplace(subscription->token, subscription);
+
+        auto next = std::make_unique<CallbackTable>(*table_.load(std::memory_order_relaxed));
+        next->lists[index(type)].push_back(subscription);
+        publish(std::move(next));
+        return subscription->token;
+    }
+
+    // Readers register in one of two counter sets, chosen by the parity of
+    // epoch_, and spread over several cache lines to avoid bouncing one line.
+    // A snapshot retired at time t is safe to free once each set has been
+    // seen empty at some point after t: every dispatch that could hold it was
+    // counted in one of the sets since before t.
+    static constexpr size_t ReaderStripes = 16;
+
+    struct alignas(64) ReaderCount {
+        std::atomic<int> value{ 0 };
+    };
+
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const EventHandler& handler)
+            : count_(handler.readers_[handler.epoch_.load(std::memory_order_seq_cst) & 1][stripe()].value) {
+            count_.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        ~ReadGuard() {
+            count_.fetch_sub(1, std::memory_order_release);
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        static size_t stripe() {
+            thread_local const size_t stripe = std::hash<std::thread::id>{}(std::this_thread::get_id()) % ReaderStripes;
+            return stripe;
+        }
+
+        std::atomic<int>& count_;
+    };
+
+    struct RetiredTable {
+        const CallbackTable* table;
+        bool seen_idle[2];
+    };
+
+    bool readersIdle(size_t parity) const {
+        for (const auto& count : readers_[parity]) {
+            if (count.value.load(std::memory_order_seq_cst) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Called with write_mutex_ held
+    void publish(std::unique_ptr<CallbackTable> next) {
+        const CallbackTable* previous = table_.exchange(next.release(), std::memory_order_seq_cst);
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        retired_.push_back(RetiredTable{ previous, { false, false } });
+        reclaim();
+    }
+
+    void reclaim() {
+        bool idle[2] = { readersIdle(0), readersIdle(1) };
+        auto keep = retired_.begin();
+        for (auto& retired : retired_) {
+            retired.seen_idle[0] |= idle[0];
+            retired.seen_idle[1] |= idle[1];
+            if (retired.seen_idle[0] && retired.seen_idle[1]) {
+                delete retired.table;
+            }
+            else {
+                *keep++ = retired;
+            }
+        }
+        retired_.erase(keep, retired_.end());
+    }
+
+    void purgeInactive() {
+        auto next = std::make_unique<CallbackTable>();
+        const CallbackTable* current = table_.load(std::memory_order_relaxed);
+        for (auto [from, to] : { std::make_pair(&current->lists, &next->lists),
+                                 std::make_pair(&current->batch_lists, &next->batch_lists) }) {
+            for (size_t type = 0; type < EventTypeCount; ++type) {
+                for (const auto& subscription : (*from)[type]) {
+                    if (subscription->active.load(std::memory_order_relaxed)) {
+                        (*to)[type].push_back(subscription);
+                    }
+                }
+            }
+        }
+        next->has_batch = current->has_batch;
+        inactive_ = 0;
+        publish(std::move(next));
+    }
+
+    std::atomic<const CallbackTable*> table_;
+    std::atomic<unsigned> epoch_{ 0 };
+    mutable ReaderCount readers_[2][ReaderStripes];
+
+    std::mutex write_mutex_;
+    std::unordered_map<CallbackToken, std::shared_ptr<Subscription>> subscriptions_;
+    std::vector<RetiredTable> retired_;
+    CallbackToken next_token_ = 1;
+    size_t inactive_ = 0;
+};
+
+// Bounded multi-producer/multi-consumer ring buffer (Vyukov's sequence-per-cell
+// design). Producers and consumers only contend on one atomic counter each and
+// never take a lock; try_push/try_pop fail instead of waiting.
+template<typename T>
+class MpmcRingBuffer {
+public:
+    explicit MpmcRingBuffer(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_push(T&& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false; // full
+            }
+            else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& value) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false; // empty
+            }
+            else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Approximate while producers or consumers are active
+    size_t size() const {
+        size_t enqueued = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t dequeued = dequeue_pos_.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> enqueue_pos_{ 0 };
+    alignas(64) std::atomic<size_t> dequeue_pos_{ 0 };
+};
+
+// Sleep/wake primitive for idle threads. Waiters read a ticket, re-check their
+// condition and then sleep until the ticket changes; notifiers only bump the
+// ticket (and pay for a wake-up) when someone is actually asleep.
+class IdleWaiter {
+public:
+    uint32_t prepare() {
+        uint32_t ticket = epoch_.load(std::memory_order_acquire);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        return ticket;
+    }
+
+    void cancel() {
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wait(uint32_t ticket) {
+#if defined(__cpp_lib_atomic_wait)
+        epoch_.wait(ticket, std::memory_order_acquire);
+#else
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return epoch_.load(std::memory_order_acquire) != ticket; });
+#endif
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify_one() {
+        // A seq_cst read-modify-write orders the caller's preceding writes
+        // against a waiter's prepare(), so either we see the sleeper or it
+        // sees the new state when it re-checks
+        if (sleepers_.fetch_add(0, std::memory_order_seq_cst) > 0) {
+            bump();
+#if defined(__cpp_lib_atomic_wait)
+            epoch_.notify_one();
+#else
+            cv_.notify_one();
+#endif
+        }
+    }
+
+    void notify_all() {
+        if (sleepers_.fetch_add(0, std::memory_order_seq_cst) == 0) {
+            return;
+        }
+        bump();
+#if defined(__cpp_lib_atomic_wait)
+        epoch_.notify_all();
+#else
+        cv_.notify_all();
+#endif
+    }
+
+private:
+    void bump() {
+#if defined(__cpp_lib_atomic_wait)
+        epoch_.fetch_add(1, std::memory_order_release);
+#else
+        std::lock_guard<std::mutex> lock(mutex_);
+        epoch_.fetch_add(1, std::memory_order_release);
+#endif
+    }
+
+    std::atomic<uint32_t> epoch_{ 0 };
+    std::atomic<int> sleepers_{ 0 };
+#if !defined(__cpp_lib_atomic_wait)
+    std::mutex mutex_;
+    std::condition_variable cv_;
+#endif
+};
+
+// Recycles fixed-size blocks for events that are too large to store inline.
+// Free blocks are kept in a lock-free ring, so once the pool is warm a
+// producer/consumer pair never reaches the global allocator.
+class EventPool {
+public:
+    static constexpr size_t BlockSize = 128;
+
+    explicit EventPool(size_t max_free_blocks = 1024) : free_blocks_(max_free_blocks) {}
+
+    ~EventPool() {
+        void* block = nullptr;
+        while (free_blocks_.try_pop(block)) {
+            ::operator delete(block);
+        }
+    }
+
+    EventPool(const EventPool&) = delete;
+    EventPool& operator=(const EventPool&) = delete;
+
+    void* allocate(size_t size) {
+        void* block = nullptr;
+        if (size <= BlockSize && free_blocks_.try_pop(block)) {
+            return block;
+        }
+        return ::operator new(std::max(size, BlockSize));
+    }
+
+    void release(void* block, size_t size) {
+        if (size > BlockSize || !free_blocks_.try_push(std::move(block))) {
+            ::operator delete(block);
+        }
+    }
+
+private:
+    MpmcRingBuffer<void*> free_blocks_;
+};
+
+// Deleter for events placed in an EventPool block. The block is kept
+// separately because the Event base need not sit at the start of it.
+struct PooledEventDeleter {
+    EventPool* pool = nullptr;
+    void* block = nullptr;
+    size_t size = 0;
+
+    void operator()(Event* event) const {
+        event->~Event();
+        pool->release(block, size);
+    }
+};
+
+using PooledEvent = std::unique_ptr<Event, PooledEventDeleter>;
+
+// Placeholder for a coalesced event: the event itself is held by the queue's
+// per-type coalescing slot until the worker reaches this position
+struct CoalescedMarker {
+    Event::Type type;
+};
+
+// An event as stored in a queue slot. The built-in events live inline in the
+// slot, so pushing them performs no allocation; any other event type is placed
+// in a recycled EventPool block, unless it is over-aligned for one.
+class QueuedEvent {
+public:
+    QueuedEvent() = default;
+
+    explicit QueuedEvent(std::unique_ptr<Event> event) : storage_(std::move(event)) {}
+
+    explicit QueuedEvent(CoalescedMarker marker) : storage_(marker) {}
+
+    template<typename E, typename... Args>
+    static QueuedEvent make(EventPool& pool, Args&&... args) {
+        QueuedEvent queued;
+        if constexpr (std::is_same_v<E, MouseClickEvent> || std::is_same_v<E, KeyPressEvent> ||
+            std::is_same_v<E, WindowResizeEvent> || std::is_same_v<E, MouseMoveEvent>) {
+            queued.storage_.template emplace<E>(std::forward<Args>(args)...);
+        }
+        else if constexpr (alignof(E) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            // Pool blocks only have operator new's default alignment; an
+            // over-aligned event gets its own allocation from aligned new
+            static_assert(std::is_base_of_v<Event, E>, "Queued events must derive from Event");
+            queued.storage_.template emplace<std::unique_ptr<Event>>(std::make_unique<E>(std::forward<Args>(args)...));
+        }
+        else {
+            static_assert(std::is_base_of_v<Event, E>, "Queued events must derive from Event");
+            void* block = pool.allocate(sizeof(E));
+            Event* event = nullptr;
+            try {
+                event = ::new (block) E(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                pool.release(block, sizeof(E));
+                throw;
+            }
+            queued.storage_.template emplace<PooledEvent>(event, PooledEventDeleter{ &pool, block, sizeof(E) });
+        }
+        return queued;
+    }
+
+    bool empty() const {
+        return std::holds_alternative<std::monostate>(storage_);
+    }
+
+    const CoalescedMarker* marker() const {
+        return std::get_if<CoalescedMarker>(&storage_);
+    }
+
+    Event& get() {
+        return const_cast<Event&>(static_cast<const QueuedEvent*>(this)->get());
+    }
+
+    const Event& get() const {
+        return std::visit([](const auto& stored) -> const Event& {
+            using Stored = std::decay_t<decltype(stored)>;
+            if constexpr (std::is_same_v<Stored, std::monostate> || std::is_same_v<Stored, CoalescedMarker>) {
+                throw std::logic_error("Queued event holds no event");
+            }
+            else if constexpr (std::is_same_v<Stored, PooledEvent> || std::is_same_v<Stored, std::unique_ptr<Event>>) {
+                return *stored;
+            }
+            else {
+                return stored;
+            }
+            }, storage_);
+    }
+
+    void reset() {
+        storage_.template emplace<std::monostate>();
+        deadline_ = NoDeadline;
+        enqueued_ = {};
+    }
+
+    // Latest time the event should be dispatched by; missing it is counted
+    void setDeadline(std::chrono::steady_clock::time_point deadline) {
+        deadline_ = deadline;
+    }
+
+    std::chrono::steady_clock::time_point deadline() const { return deadline_; }
+    bool hasDeadline() const { return deadline_ != NoDeadline; }
+
+    // Only stamped by queues with instrumentation enabled
+    void setEnqueueTime(std::chrono::steady_clock::time_point time) {
+        enqueued_ = time;
+    }
+
+    std::chrono::steady_clock::time_point enqueueTime() const { return enqueued_; }
+
+private:
+    static constexpr std::chrono::steady_clock::time_point NoDeadline = std::chrono::steady_clock::time_point::max();
+
+    std::variant<std::monostate, MouseClickEvent, KeyPressEvent, WindowResizeEvent, MouseMoveEvent,
+        PooledEvent, std::unique_ptr<Event>, CoalescedMarker> storage_;
+    std::chrono::steady_clock::time_point deadline_ = NoDeadline;
+    std::chrono::steady_clock::time_point enqueued_{};
 };
 
 class EventQueue {
 public:
-    EventQueue() : running_(false) {}
+    // What pushEvent does when the queue is full
+    enum class FullPolicy {
+        Block,      // wait until a slot frees up
+        DropNewest, // discard the event being pushed
+        DropOldest  // discard the oldest queued event to make room
+    };
+
+    // How bursts of one event type are folded together at enqueue time
+    enum class CoalescePolicy {
+        Never,      // every event is queued
+        KeepLatest, // a pending event of the type is replaced by the newer one
+        Merge       // a newer event is merged into the pending one
+    };
+
+    // merge(pending, incoming) folds incoming into the still-queued event
+    using MergeFunction = std::function<void(Event& pending, const Event& incoming)>;
+
+    // Upper bound on events handed to EventHandler::dispatchBatch per wakeup
+    static constexpr size_t MaxBatch = 64;
+
+    // A priority lane: lane 0 is drained first. Each drain round takes up to
+    // weight events from every lane in order, so lower lanes always get a
+    // share and cannot starve behind a flooded higher lane.
+    struct LaneConfig {
+        size_t capacity = 4096;
+        unsigned weight = 1;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    // Per-type queue-wait (enqueue to dispatch) and callback-time latencies
+    struct Stats {
+        size_t peak_depth = 0;
+        std::array<LatencyHistogram::Snapshot, EventTypeCount> queue_wait;
+        std::array<LatencyHistogram::Snapshot, EventTypeCount> callback_time;
+
+        void merge(const Stats& other) {
+            peak_depth = std::max(peak_depth, other.peak_depth);
+            for (size_t type = 0; type < EventTypeCount; ++type) {
+                queue_wait[type].merge(other.queue_wait[type]);
+                callback_time[type].merge(other.callback_time[type]);
+            }
+        }
+    };
+
+    explicit EventQueue(size_t capacity = 4096, FullPolicy policy = FullPolicy::Block)
+        : EventQueue(std::vector<LaneConfig>{ LaneConfig{ capacity, 1 } }, policy) {}
+
+    // Every type starts out in the last (lowest priority) lane, see setLane
+    explicit EventQueue(const std::vector<LaneConfig>& lanes, FullPolicy policy = FullPolicy::Block)
+        : pool_(lanes.empty() ? 1 : lanes.front().capacity), policy_(policy), running_(false) {
+        if (lanes.empty()) {
+            throw std::invalid_argument("EventQueue needs at least one lane");
+        }
+        for (const auto& config : lanes) {
+            lanes_.push_back(std::make_unique<Lane>(config));
+        }
+        std::fill(std::begin(type_lane_), std::end(type_lane_), lanes_.size() - 1);
+    }
+
+    // Route every event of a type to a lane; call before start()
+    void setLane(Event::Type type, size_t lane) {
+        if (lane >= lanes_.size()) {
+            throw std::out_of_range("No such lane: " + std::to_string(lane));
+        }
+        type_lane_[static_cast<size_t>(type)] = lane;
+    }
+
+    // Record latency histograms and peak depth; call before start(). Costs
+    // a clock read per push and two per dispatched event.
+    void enableInstrumentation() {
+        if (!latency_) {
+            latency_ = std::make_unique<Latency>();
+        }
+    }
 
     void start(EventHandler& handler) {
         running_ = true;
         worker_thread_ = std::thread(&EventQueue::processEvents, this, std::ref(handler));
     }
 
+    // Configure coalescing for a type; call before start()
+    void setCoalescePolicy(Event::Type type, CoalescePolicy policy, MergeFunction merge = nullptr) {
+        if (policy == CoalescePolicy::Merge && !merge) {
+            throw std::invalid_argument("Merge coalescing needs a merge function");
+        }
+        CoalesceSlot& slot = coalesce_[static_cast<size_t>(type)];
+        slot.policy = policy;
+        slot.merge = std::move(merge);
+    }
+
     void stop() {
         running_ = false;
-        cv_.notify_one();
+        not_empty_.notify_all();
         if (worker_thread_.joinable()) {
             worker_thread_.join();
         }
     }
 
-    void pushEvent(std::unique_ptr<Event> event) {
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            events_.push(std::move(event));
+    // Construct an event directly in the queue; built-in events are stored
+    // inline and custom events in a recycled pool block
+    template<typename E, typename... Args>
+    bool emplaceEvent(Args&&... args) {
+        return pushEvent(QueuedEvent::make<E>(pool_, std::forward<Args>(args)...));
+    }
+
+    // Same as emplaceEvent, for an event that should be dispatched by deadline
+    template<typename E, typename... Args>
+    bool emplaceEventBefore(Clock::time_point deadline, Args&&... args) {
+        QueuedEvent event = QueuedEvent::make<E>(pool_, std::forward<Args>(args)...);
+        event.setDeadline(deadline);
+        return pushEvent(std::move(event));
+    }
+
+    bool pushEvent(std::unique_ptr<Event> event) {
+        return pushEvent(QueuedEvent(std::move(event)));
+    }
+
+    // Returns false if the event was dropped because the queue was full
+    bool pushEvent(QueuedEvent event) {
+        Event::Type type = event.get().getType();
+        MpmcRingBuffer<QueuedEvent>& ring = lanes_[type_lane_[static_cast<size_t>(type)]]->ring;
+        if (latency_) {
+            event.setEnqueueTime(Clock::now());
+        }
+
+        CoalesceSlot& slot = coalesce_[static_cast<size_t>(type)];
+        if (slot.policy != CoalescePolicy::Never) {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            if (slot.queued) {
+                if (slot.policy == CoalescePolicy::KeepLatest) {
+                    slot.pending = std::move(event);
+                }
+                else {
+                    slot.merge(slot.pending.get(), event.get());
+                }
+                ++slot.folded;
+                coalesced_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            Clock::time_point enqueued = event.enqueueTime();
+            slot.pending = std::move(event);
+            slot.queued = true;
+            event = QueuedEvent(CoalescedMarker{ type });
+            event.setEnqueueTime(enqueued);
+        }
+
+        while (!ring.try_push(std::move(event))) {
+            switch (policy_) {
+            case FullPolicy::DropNewest:
+                discard(event);
+                return false;
+            case FullPolicy::DropOldest: {
+                QueuedEvent oldest;
+                if (ring.try_pop(oldest)) {
+                    discard(oldest);
+                }
+                break;
+            }
+            case FullPolicy::Block: {
+                uint32_t ticket = not_full_.prepare();
+                if (ring.size() < ring.capacity()) {
+                    not_full_.cancel();
+                }
+                else {
+                    not_full_.wait(ticket);
+                }
+                break;
+            }
+            }
+        }
+        if (latency_) {
+            notePeakDepth();
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Events currently queued across all lanes (approximate while running)
+    size_t queuedEvents() const {
+        size_t depth = 0;
+        for (const auto& lane : lanes_) {
+            depth += lane->ring.size();
         }
-        cv_.notify_one();
+        return depth;
+    }
+
+    // Copy of the current histograms; empty unless instrumentation is enabled.
+    // Only reads counters, so it is cheap enough to poll while running.
+    Stats stats() const {
+        Stats result;
+        if (latency_) {
+            result.peak_depth = latency_->peak_depth.load(std::memory_order_relaxed);
+            for (size_t type = 0; type < EventTypeCount; ++type) {
+                result.queue_wait[type] = latency_->queue_wait[type].snapshot();
+                result.callback_time[type] = latency_->callback_time[type].snapshot();
+            }
+        }
+        return result;
+    }
+
+    // Events lost to the full policy. Dropping a coalesced event counts
+    // every push folded into it, since each of them had returned true.
+    size_t droppedEvents() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    // Events folded into an already queued event of the same type
+    size_t coalescedEvents() const {
+        return coalesced_.load(std::memory_order_relaxed);
+    }
+
+    // Events dispatched after their deadline had passed
+    size_t missedDeadlines() const {
+        return missed_deadlines_.load(std::memory_order_relaxed);
     }
 
 private:
-    void processEvents(EventHandler& handler) {
-        while (running_) {
-            std::unique_ptr<Event> event;
-            {
-                std::unique_lock<std::mutex> lock(mutex_);
-                cv_.wait(lock, [this] { return !events_.empty() || !running_; });
-                if (!running_ && events_.empty()) {
-                    return;
+    struct Lane {
+        explicit Lane(const LaneConfig& config) : ring(config.capacity), weight(std::max(1u, config.weight)) {}
+
+        MpmcRingBuffer<QueuedEvent> ring;
+        unsigned weight;
+    };
+
+    struct Latency {
+        LatencyByType queue_wait;
+        LatencyByType callback_time;
+        std::atomic<size_t> peak_depth{ 0 };
+    };
+
+    void notePeakDepth() {
+        size_t depth = queuedEvents();
+        size_t peak = latency_->peak_depth.load(std::memory_order_relaxed);
+        while (depth > peak && !latency_->peak_depth.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    struct CoalesceSlot {
+        CoalescePolicy policy = CoalescePolicy::Never;
+        MergeFunction merge;
+        std::mutex mutex;
+        QueuedEvent pending;
+        size_t folded = 0;   // pushes merged into pending since it was queued
+        bool queued = false; // a marker for pending is in the ring
+    };
+
+    // Take the event a marker stands for out of its coalescing slot; folded,
+    // if given, receives how many later pushes were merged into it
+    QueuedEvent resolve(QueuedEvent event, size_t* folded = nullptr) {
+        if (const CoalescedMarker* marker = event.marker()) {
+            CoalesceSlot& slot = coalesce_[static_cast<size_t>(marker->type)];
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            slot.queued = false;
+            if (folded) {
+                *folded = slot.folded;
+            }
+            slot.folded = 0;
+            // The wait started when the marker was queued, not at the last merge
+            QueuedEvent pending = std::move(slot.pending);
+            pending.setEnqueueTime(event.enqueueTime());
+            return pending;
+        }
+        return event;
+    }
+
+    void discard(QueuedEvent& event) {
+        size_t folded = 0;
+        resolve(std::move(event), &folded);
+        dropped_.fetch_add(1 + folded, std::memory_order_relaxed);
+    }
+
+    // Pop up to MaxBatch events into batch, in weighted rounds over the lanes
+    bool drain(std::vector<QueuedEvent>& batch) {
+        QueuedEvent event;
+        bool progress = true;
+        while (progress && batch.size() < MaxBatch) {
+            progress = false;
+            for (auto& lane : lanes_) {
+                for (unsigned taken = 0; taken < lane->weight && batch.size() < MaxBatch && lane->ring.try_pop(event); ++taken) {
+                    batch.push_back(resolve(std::move(event)));
+                    progress = true;
                 }
-                event = std::move(events_.front());
-                events_.pop();
             }
-            handler.dispatchEvent(*event);
         }
+        if (batch.empty()) {
+            return false;
+        }
+        not_full_.notify_all();
+        return true;
     }
 
-    std::queue<std::unique_ptr<Event>> events_;
-    std::mutex mutex_;
-    std::condition_variable cv_;
+    void dispatch(EventHandler& handler, std::vector<QueuedEvent>& batch, std::vector<const Event*>& views) {
+        views.clear();
+        Clock::time_point now = latency_ ? Clock::now() : Clock::time_point{};
+        bool has_deadlines = false;
+        for (const auto& queued : batch) {
+            if (latency_) {
+                latency_->queue_wait[static_cast<size_t>(queued.get().getType())].record(now - queued.enqueueTime());
+            }
+            has_deadlines |= queued.hasDeadline();
+            views.push_back(&queued.get());
+        }
+        LatencyByType* callback_time = latency_ ? &latency_->callback_time : nullptr;
+        if (has_deadlines) {
+            // Read the clock as each event starts, so events held up by slow
+            // callbacks earlier in the batch are counted as late
+            handler.dispatchBatch(views, callback_time, [this, &batch](size_t i) {
+                if (batch[i].hasDeadline() && Clock::now() > batch[i].deadline()) {
+                    missed_deadlines_.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        else {
+            handler.dispatchBatch(views, callback_time);
+        }
+        batch.clear();
+    }
+
+    void processEvents(EventHandler& handler) {
+        std::vector<QueuedEvent> batch;
+        std::vector<const Event*> views;
+        batch.reserve(MaxBatch);
+        views.reserve(MaxBatch);
+        while (true) {
+            if (drain(batch)) {
+                dispatch(handler, batch, views);
+                continue;
+            }
+            uint32_t ticket = not_empty_.prepare();
+            if (drain(batch)) {
+                not_empty_.cancel();
+                dispatch(handler, batch, views);
+                continue;
+            }
+            if (!running_) {
+                not_empty_.cancel();
+                return;
+            }
+            not_empty_.wait(ticket);
+        }
+    }
+
+    EventPool pool_; // declared first so it outlives every queued event
+    CoalesceSlot coalesce_[EventTypeCount];
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    size_t type_lane_[EventTypeCount];
+    FullPolicy policy_;
+    IdleWaiter not_empty_;
+    IdleWaiter not_full_;
+    std::atomic<size_t> dropped_{ 0 };
+    std::atomic<size_t> coalesced_{ 0 };
+    std::atomic<size_t> missed_deadlines_{ 0 };
+    std::unique_ptr<Latency> latency_;
     std::atomic<bool> running_;
     std::thread worker_thread_;
 };
 
+// Multi-worker queue: events are sharded across several EventQueues, each with
+// its own ring and worker thread. All events that map to the same shard key
+// are dispatched in push order by one worker; different shards run in parallel.
+class ShardedEventQueue {
+public:
+    using ShardKey = std::function<size_t(const Event&)>;
+
+    // By default events are sharded by type, so each type keeps its ordering
+    static size_t byType(const Event& event) {
+        return static_cast<size_t>(event.getType());
+    }
+
+    explicit ShardedEventQueue(size_t workers, ShardKey key = byType,
+        size_t capacity_per_worker = 4096, EventQueue::FullPolicy policy = EventQueue::FullPolicy::Block)
+        : key_(std::move(key)) {
+        for (size_t i = 0; i < std::max<size_t>(1, workers); ++i) {
+            shards_.push_back(std::make_unique<EventQueue>(capacity_per_worker, policy));
+        }
+    }
+
+    // Every shard gets the same priority lanes
+    ShardedEventQueue(size_t workers, const std::vector<EventQueue::LaneConfig>& lanes, ShardKey key = byType,
+        EventQueue::FullPolicy policy = EventQueue::FullPolicy::Block)
+        : key_(std::move(key)) {
+        for (size_t i = 0; i < std::max<size_t>(1, workers); ++i) {
+            shards_.push_back(std::make_unique<EventQueue>(lanes, policy));
+        }
+    }
+
+    void setLane(Event::Type type, size_t lane) {
+        for (auto& shard : shards_) {
+            shard->setLane(type, lane);
+        }
+    }
+
+    void enableInstrumentation() {
+        for (auto& shard : shards_) {
+            shard->enableInstrumentation();
+        }
+    }
+
+    // Histograms merged across shards; peak_depth is the deepest single shard
+    EventQueue::Stats stats() const {
+        EventQueue::Stats result;
+        for (const auto& shard : shards_) {
+            result.merge(shard->stats());
+        }
+        return result;
+    }
+
+    void start(EventHandler& handler) {
+        for (auto& shard : shards_) {
+            shard->start(handler);
+        }
+    }
+
+    void setCoalescePolicy(Event::Type type, EventQueue::CoalescePolicy policy,
+        EventQueue::MergeFunction merge = nullptr) {
+        for (auto& shard : shards_) {
+            shard->setCoalescePolicy(type, policy, merge);
+        }
+    }
+
+    // Stops every worker once its shard is drained
+    void stop() {
+        for (auto& shard : shards_) {
+            shard->stop();
+        }
+    }
+
+    template<typename E, typename... Args>
+    bool emplaceEvent(Args&&... args) {
+        return pushEvent(QueuedEvent::make<E>(pool_, std::forward<Args>(args)...));
+    }
+
+    bool pushEvent(std::unique_ptr<Event> event) {
+        return pushEvent(QueuedEvent(std::move(event)));
+    }
+
+    bool pushEvent(QueuedEvent event) {
+        size_t shard = key_(event.get()) % shards_.size();
+        return shards_[shard]->pushEvent(std::move(event));
+    }
+
+    size_t workerCount() const {
+        return shards_.size();
+    }
+
+    size_t droppedEvents() const {
+        size_t dropped = 0;
+        for (const auto& shard : shards_) {
+            dropped += shard->droppedEvents();
+        }
+        return dropped;
+    }
+
+    size_t missedDeadlines() const {
+        size_t missed = 0;
+        for (const auto& shard : shards_) {
+            missed += shard->missedDeadlines();
+        }
+        return missed;
+    }
+
+private:
+    ShardKey key_;
+    EventPool pool_; // declared before shards_ so it outlives their queued events
+    std::vector<std::unique_ptr<EventQueue>> shards_;
+};
+
+// Measure dispatch throughput for a callback that does a fixed amount of work,
+// with events sharded by a per-source key (the click's x coordinate)
+void benchmarkWorkerScaling() {
+    const int events = 200000;
+    const int sources = 64;
+
+    EventHandler handler;
+    handler.registerCallback(Event::Type::MouseClick, [](const Event& e) {
+        const auto& mouseEvent = static_cast<const MouseClickEvent&>(e);
+        volatile unsigned sink = 0;
+        for (unsigned i = 0; i < 200; ++i) {
+            sink = sink + static_cast<unsigned>(mouseEvent.getY()) * i;
+        }
+        });
+
+    auto bySource = [](const Event& e) {
+        return static_cast<size_t>(static_cast<const MouseClickEvent&>(e).getX());
+    };
+
+    std::cout << "Dispatch throughput by worker count:\n";
+    for (size_t workers : { 1, 2, 4, 8 }) {
+        ShardedEventQueue queue(workers, bySource);
+        auto begin = std::chrono::steady_clock::now();
+        queue.start(handler);
+        for (int i = 0; i < events; ++i) {
+            queue.emplaceEvent<MouseClickEvent>(i % sources, i);
+        }
+        queue.stop();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << "  " << workers << " worker(s): " << static_cast<long long>(events / elapsed.count()) << " events/s\n";
+    }
+}
+
+// Measure dispatch cost while another thread keeps registering and
+// unregistering callbacks for the same event type
+void benchmarkDispatchUnderChurn() {
+    const int dispatches = 1000000;
+    const int dispatch_threads = 2;
+
+    for (bool churn : { false, true }) {
+        EventHandler handler;
+        std::atomic<long long> calls{ 0 };
+        for (int i = 0; i < 4; ++i) {
+            handler.registerCallback(Event::Type::KeyPress, [&calls](const Event&) {
+                calls.fetch_add(1, std::memory_order_relaxed);
+                });
+        }
+
+        std::atomic<bool> done{ false };
+        std::thread churner;
+        if (churn) {
+            churner = std::thread([&] {
+                while (!done.load(std::memory_order_relaxed)) {
+                    auto token = handler.registerCallback(Event::Type::KeyPress, [](const Event&) {});
+                    handler.unregisterCallback(token);
+                }
+                });
+        }
+
+        KeyPressEvent event('x');
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<std::thread> dispatchers;
+        for (int t = 0; t < dispatch_threads; ++t) {
+            dispatchers.emplace_back([&] {
+                for (int i = 0; i < dispatches; ++i) {
+                    handler.dispatchEvent(event);
+                }
+                });
+        }
+        for (auto& dispatcher : dispatchers) {
+            dispatcher.join();
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+
+        done = true;
+        if (churner.joinable()) {
+            churner.join();
+        }
+        std::cout << "Dispatch " << (churn ? "with" : "without") << " registration churn: "
+            << elapsed.count() / (static_cast<double>(dispatches) * dispatch_threads) << " ns/dispatch\n";
+    }
+}
+
+// Compare the delegate table against the original design: a shared_mutex
+// guarding an unordered_map of std::function lists, with a manual downcast
+void benchmarkDelegateDispatch() {
+    const int dispatches = 5000000;
+    MouseClickEvent event(3, 4);
+    long long sum = 0;
+
+    std::shared_mutex mutex;
+    std::unordered_map<Event::Type, std::vector<std::function<void(const Event&)>>> map_callbacks;
+    map_callbacks[Event::Type::MouseClick].push_back([&sum](const Event& e) {
+        sum += static_cast<const MouseClickEvent&>(e).getX();
+        });
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < dispatches; ++i) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = map_callbacks.find(event.getType());
+        if (it != map_callbacks.end()) {
+            for (const auto& callback : it->second) {
+                callback(event);
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> map_elapsed = std::chrono::steady_clock::now() - begin;
+
+    EventHandler handler;
+    handler.on<MouseClickEvent>([&sum](const MouseClickEvent& e) { sum += e.getX(); });
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < dispatches; ++i) {
+        handler.dispatchEvent(event);
+    }
+    std::chrono::duration<double, std::nano> table_elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::cout << "unordered_map + std::function dispatch: " << map_elapsed.count() / dispatches << " ns\n";
+    std::cout << "Dense delegate table dispatch: " << table_elapsed.count() / dispatches << " ns"
+        << " (checksum " << sum << ")\n";
+}
+
 int main() {
     EventQueue queue;
     EventHandler handler;
 
     // Register callbacks for different event types
-    handler.registerCallback(Event::Type::MouseClick, [](const Event& e) {
-        const auto& mouseEvent = static_cast<const MouseClickEvent&>(e);
+    handler.on<MouseClickEvent>([](const MouseClickEvent& mouseEvent) {
         std::cout << "Mouse clicked at (" << mouseEvent.getX() << ", " << mouseEvent.getY() << ")\n";
         });
 
@@ -162,14 +1558,29 @@ int main() {
         std::cout << "Window resized to " << resizeEvent.getWidth() << "x" << resizeEvent.getHeight() << "\n";
         });
 
+    handler.registerCallback(Event::Type::Custom, [](const Event& e) {
+        const auto& textEvent = static_cast<const TextInputEvent&>(e);
+        std::cout << "Text input: " << textEvent.getText() << "\n";
+        });
+
+    // Mouse moves arrive in bursts: merge them and take them as one span
+    handler.registerBatchCallback(Event::Type::MouseMove, [](EventSpan moves) {
+        for (const Event* e : moves) {
+            const auto& moveEvent = static_cast<const MouseMoveEvent&>(*e);
+            std::cout << "Mouse moved by (" << moveEvent.getDeltaX() << ", " << moveEvent.getDeltaY() << ")\n";
+        }
+        });
+
     // Start the event processing thread, passing the handler
+    queue.enableInstrumentation();
     queue.start(handler);
 
     // Simulate events occurring over time
     for (int i = 0; i < 5; ++i) {
-        queue.pushEvent(std::make_unique<MouseClickEvent>(i * 10, i * 20));
-        queue.pushEvent(std::make_unique<KeyPressEvent>('A' + i));
-        queue.pushEvent(std::make_unique<WindowResizeEvent>(800 + i * 10, 600 + i * 10));
+        queue.emplaceEvent<MouseClickEvent>(i * 10, i * 20);
+        queue.emplaceEvent<KeyPressEvent>('A' + i);
+        queue.emplaceEvent<WindowResizeEvent>(800 + i * 10, 600 + i * 10);
+        queue.emplaceEvent<TextInputEvent>("text #" + std::to_string(i));
 
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
@@ -182,5 +1593,60 @@ int main() {
 
     std::cout << "Event processing completed.\n";
 
+    // Latency per type: time spent queued and time spent in callbacks
+    EventQueue::Stats stats = queue.stats();
+    const char* typeNames[EventTypeCount] = { "MouseClick", "KeyPress", "WindowResize", "MouseMove", "Custom" };
+    std::cout << "Peak queue depth: " << stats.peak_depth << "\n";
+    for (size_t type = 0; type < EventTypeCount; ++type) {
+        const auto& wait = stats.queue_wait[type];
+        if (wait.count() == 0) {
+            continue;
+        }
+        const auto& callback = stats.callback_time[type];
+        std::cout << "  " << typeNames[type] << ": " << wait.count() << " events, queue wait p50 "
+            << wait.percentile(50) << " ns / p99 " << wait.percentile(99) << " ns, callback p50 "
+            << callback.percentile(50) << " ns / max " << callback.max() << " ns\n";
+    }
+
+    // One frame's worth of bursty input: only the last resize and the summed
+    // mouse movement reach the callbacks
+    EventQueue frameQueue;
+    frameQueue.setCoalescePolicy(Event::Type::WindowResize, EventQueue::CoalescePolicy::KeepLatest);
+    frameQueue.setCoalescePolicy(Event::Type::MouseMove, EventQueue::CoalescePolicy::Merge,
+        [](Event& pending, const Event& incoming) {
+            static_cast<MouseMoveEvent&>(pending).accumulate(static_cast<const MouseMoveEvent&>(incoming));
+        });
+    for (int i = 0; i < 10; ++i) {
+        frameQueue.emplaceEvent<WindowResizeEvent>(1024 + i, 768 + i);
+        frameQueue.emplaceEvent<MouseMoveEvent>(1, -1);
+    }
+    frameQueue.start(handler);
+    frameQueue.stop();
+    std::cout << "Frame processed, " << frameQueue.coalescedEvents() << " events coalesced.\n";
+
+    // Key presses get their own high-priority lane, so they overtake a
+    // backlog of custom events instead of waiting behind it
+    EventQueue laneQueue({ EventQueue::LaneConfig{ 256, 8 }, EventQueue::LaneConfig{ 4096, 1 } });
+    laneQueue.setLane(Event::Type::KeyPress, 0);
+
+    EventHandler laneHandler;
+    int customBefore = 0;
+    int customDispatched = 0;
+    laneHandler.on<TextInputEvent>([&customDispatched](const TextInputEvent&) { ++customDispatched; });
+    laneHandler.on<KeyPressEvent>([&](const KeyPressEvent&) { customBefore = customDispatched; });
+
+    for (int i = 0; i < 1000; ++i) {
+        laneQueue.emplaceEvent<TextInputEvent>("backlog");
+    }
+    laneQueue.emplaceEventBefore<KeyPressEvent>(EventQueue::Clock::now() + std::chrono::milliseconds(5), 'Q');
+    laneQueue.start(laneHandler);
+    laneQueue.stop();
+    std::cout << "Key press dispatched after " << customBefore << " of " << customDispatched
+        << " backlogged events, " << laneQueue.missedDeadlines() << " deadline(s) missed.\n";
+
+    benchmarkWorkerScaling();
+    benchmarkDispatchUnderChurn();
+    benchmarkDelegateDispatch();
+
     return 0;
 }
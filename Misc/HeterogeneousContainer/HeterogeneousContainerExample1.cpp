@@ -1,4 +1,3 @@
-#include <any>
 #include <vector>
 #include <unordered_map>
 #include <typeindex>
@@ -8,12 +7,23 @@
 #include <stdexcept>
 #include <string>
 #include <iostream>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
 
 // Tag structs for specialization
 struct Shrinkable {};
 struct NonShrinkable {};
 
-// We define two exceptions for the container
+// Tag structs for the storage layout
+struct BoxedStorage {};  // every element is boxed on its own (default)
+struct ColumnStorage {}; // every type is kept in its own contiguous std::vector<T>
+
+// We define the exceptions for the container
 class ContainerException : public std::runtime_error {
 public:
     explicit ContainerException(const std::string& message) : std::runtime_error(message) {}
@@ -25,6 +35,18 @@ public:
         : ContainerException("Invalid index: " + std::to_string(index)) {}
 };
 
+class InvalidTypeSlotException : public ContainerException {
+public:
+    explicit InvalidTypeSlotException(uint32_t type)
+        : ContainerException("Invalid type slot: " + std::to_string(type)) {}
+};
+
+class StaleHandleException : public ContainerException {
+public:
+    explicit StaleHandleException(size_t index, uint32_t generation)
+        : ContainerException("Stale handle: " + std::to_string(index) + " (generation " + std::to_string(generation) + ")") {}
+};
+
 class TypeMismatchException : public ContainerException {
 public:
     explicit TypeMismatchException(const std::string& expected, const std::string& actual)
@@ -41,116 +63,276 @@ struct ISizedObject {
 template<typename T>
 class SizedObject : public ISizedObject {
 private:
-    std::unique_ptr<T> value;
-    size_t object_size;
+    T value;
 
 public:
     template<typename U>
-    SizedObject(U&& val) : value(std::make_unique<T>(std::forward<U>(val))),
-        object_size(sizeof(T) + sizeof(std::unique_ptr<T>)) {}
+    SizedObject(U&& val) : value(std::forward<U>(val)) {}
+
+    const T& get() const { return value; }
+    T& get() { return value; }
+    size_t size() const override { return sizeof(SizedObject); }
+};
 
-    const T& get() const { return *value; }
-    T& get() { return *value; }
-    size_t size() const override { return object_size; }
+// Handle to an element. The generation is bumped every time a slot is
+// freed, so a handle to a removed element is detected instead of silently
+// resolving to whatever was inserted into the same slot later. Slots are
+// created at FirstGeneration and bump_generation skips 0, so get() on a
+// default Handle throws instead of returning the element in slot 0.
+struct Handle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
 };
 
-// The main container class
-template<typename ShrinkPolicy>
+constexpr uint32_t EmptySlot = 0xFFFFFFFFu;
+constexpr uint32_t FirstGeneration = 1;
+
+// Advance a slot's generation, skipping the never-valid 0 on wraparound
+inline void bump_generation(uint32_t& generation) {
+    if (++generation == 0) {
+        generation = FirstGeneration;
+    }
+}
+
+// Make sure the next push_back cannot reallocate, growing geometrically like
+// push_back itself would. Inserts call this for every vector they touch
+// before changing any of them, so a bad_alloc leaves the container as it was.
+template<typename V>
+void reserve_one_more(V& vec) {
+    if (vec.size() == vec.capacity()) {
+        vec.reserve(vec.capacity() == 0 ? 1 : vec.capacity() * 2);
+    }
+}
+
+// The main container class. Trivially copyable values of at most InlineSize
+// bytes are stored in place; anything else costs one heap allocation.
+template<typename ShrinkPolicy, typename StoragePolicy = BoxedStorage, size_t InlineSize = 16>
 class HeterogeneousContainer {
 private:
-    std::vector<std::any> data;
-    std::unordered_map<std::type_index, std::vector<size_t>> type_indices;
-    std::vector<size_t> free_indices;
+    static_assert(InlineSize >= sizeof(ISizedObject*), "InlineSize must fit a pointer");
+
+    template<typename T>
+    static constexpr bool stored_inline = std::is_trivially_copyable_v<T> &&
+        sizeof(T) <= InlineSize && alignof(T) <= alignof(std::max_align_t);
+
+    // One element: either the value itself or a pointer to its SizedObject
+    struct Box {
+        alignas(std::max_align_t) unsigned char storage[InlineSize];
+        const std::type_info* type = nullptr; // nullptr marks a hole
+        bool is_inline = false;
+
+        Box() = default;
+        Box(const Box&) = delete;
+        Box& operator=(const Box&) = delete;
+
+        Box(Box&& other) noexcept {
+            *this = std::move(other);
+        }
+
+        Box& operator=(Box&& other) noexcept {
+            if (this != &other) {
+                reset();
+                std::memcpy(storage, other.storage, InlineSize);
+                type = other.type;
+                is_inline = other.is_inline;
+                other.type = nullptr;
+            }
+            return *this;
+        }
+
+        ~Box() {
+            reset();
+        }
+
+        bool has_value() const { return type != nullptr; }
+
+        ISizedObject* heap_object() const {
+            ISizedObject* object;
+            std::memcpy(&object, storage, sizeof(object));
+            return object;
+        }
+
+        // Bytes owned outside the box itself
+        size_t heap_bytes() const {
+            return has_value() && !is_inline ? heap_object()->size() : 0;
+        }
+
+        template<typename T, typename U>
+        void emplace(U&& value) {
+            reset();
+            if constexpr (stored_inline<T>) {
+                ::new (static_cast<void*>(storage)) T(std::forward<U>(value));
+                is_inline = true;
+            }
+            else {
+                ISizedObject* object = new SizedObject<T>(std::forward<U>(value));
+                std::memcpy(storage, &object, sizeof(object));
+                is_inline = false;
+            }
+            type = &typeid(T);
+        }
+
+        template<typename T>
+        T& get() {
+            if constexpr (stored_inline<T>) {
+                return *std::launder(reinterpret_cast<T*>(storage));
+            }
+            else {
+                return static_cast<SizedObject<T>*>(heap_object())->get();
+            }
+        }
+
+        void reset() {
+            if (has_value() && !is_inline) {
+                delete heap_object();
+            }
+            type = nullptr;
+        }
+    };
+
+    // Slot map: handles index into slots, slots point into data.
+    // Compaction only has to patch the one slot that owns a moved element.
+    struct Slot {
+        uint32_t dense;      // position in data, EmptySlot if free
+        uint32_t generation;
+    };
+
+    std::vector<Box> data;
+    std::vector<uint32_t> data_slot;  // owning slot of data[i], EmptySlot for holes
+    std::vector<Slot> slots;
+    std::vector<uint32_t> free_slots;
+    std::vector<size_t> free_indices; // holes in data left by remove()
+    std::unordered_map<std::type_index, size_t> type_counts;
+    size_t heap_bytes = 0;            // running total of boxed objects, kept for size_bytes()
+
+    const Slot& checked_slot(Handle handle) const {
+        if (handle.index >= slots.size()) {
+            throw InvalidIndexException(handle.index);
+        }
+        const Slot& slot = slots[handle.index];
+        if (slot.generation != handle.generation || slot.dense == EmptySlot) {
+            throw StaleHandleException(handle.index, handle.generation);
+        }
+        return slot;
+    }
 
 public:
 
     template<typename T>
-    size_t insert(T&& value) {
+    Handle insert(T&& value) {
+        using U = std::decay_t<T>;
+
+        // Everything that can throw happens first: constructing the value,
+        // growing the vectors and the per-type counter. The rest cannot fail.
+        Box box;
+        box.template emplace<U>(std::forward<T>(value));
+        if (free_slots.empty()) {
+            reserve_one_more(slots);
+        }
+        if (free_indices.empty()) {
+            reserve_one_more(data);
+            reserve_one_more(data_slot);
+        }
+        size_t& type_count = type_counts.try_emplace(std::type_index(typeid(U)), 0).first->second;
+
+        uint32_t slot_index;
+        if (!free_slots.empty()) {
+            slot_index = free_slots.back();
+            free_slots.pop_back();
+        }
+        else {
+            slot_index = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot{ EmptySlot, FirstGeneration });
+        }
+
         size_t index;
-        std::shared_ptr<ISizedObject> sized_obj = std::make_shared<SizedObject<std::decay_t<T>>>(std::forward<T>(value));
         if (!free_indices.empty()) {
             index = free_indices.back();
             free_indices.pop_back();
-            data[index] = sized_obj;
+            data[index] = std::move(box);
         }
         else {
             index = data.size();
-            data.push_back(sized_obj);
+            data.push_back(std::move(box));
+            data_slot.push_back(EmptySlot);
         }
-        type_indices[std::type_index(typeid(T))].push_back(index);
-        return index;
+        data_slot[index] = slot_index;
+
+        slots[slot_index].dense = static_cast<uint32_t>(index);
+        ++type_count;
+        heap_bytes += data[index].heap_bytes();
+        return Handle{ slot_index, slots[slot_index].generation };
     }
 
     template<typename T>
-    T& get(size_t index) {
-        if (index >= data.size()) {
-            throw InvalidIndexException(index);
-        }
-        auto ptr = std::any_cast<std::shared_ptr<ISizedObject>>(&data[index]);
-        if (!ptr) {
-            throw TypeMismatchException(typeid(T).name(), data[index].type().name());
-        }
-        auto derived_ptr = std::dynamic_pointer_cast<SizedObject<T>>(*ptr);
-        if (!derived_ptr) {
-            throw TypeMismatchException(typeid(T).name(), typeid(*ptr->get()).name());
+    T& get(Handle handle) {
+        Box& box = data[checked_slot(handle).dense];
+        if (*box.type != typeid(T)) {
+            throw TypeMismatchException(typeid(T).name(), box.type->name());
         }
-        return derived_ptr->get();
+        return box.template get<T>();
+    }
+
+    template<typename T>
+    const T& get(Handle handle) const {
+        return const_cast<HeterogeneousContainer*>(this)->template get<T>(handle);
+    }
+
+    // Check whether a handle still refers to a live element
+    bool contains(Handle handle) const {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation &&
+            slots[handle.index].dense != EmptySlot;
     }
 
+    // Number of stored values of type T
     template<typename T>
-    const T& get(size_t index) const {
-        return const_cast<HeterogeneousContainer*>(this)->get<T>(index);
+    size_t count() const {
+        auto it = type_counts.find(std::type_index(typeid(T)));
+        return it != type_counts.end() ? it->second : 0;
     }
 
+    // O(1): element bytes are tracked on insert and remove
     size_t size_bytes() const {
         size_t total_size = sizeof(*this);
 
-        // Data vector
-        total_size += sizeof(std::vector<std::any>) + (data.capacity() * sizeof(std::any));
+        // Data vector (inline values live here) and its slot back-references
+        total_size += data.capacity() * sizeof(Box) + data_slot.capacity() * sizeof(uint32_t);
 
-        // Type indices map
-        total_size += sizeof(std::unordered_map<std::type_index, std::vector<size_t>>);
-        for (const auto& [type, indices] : type_indices) {
-            total_size += sizeof(std::type_index) + sizeof(std::vector<size_t>) + (indices.capacity() * sizeof(size_t));
-        }
+        // Slot map
+        total_size += slots.capacity() * sizeof(Slot) + free_slots.capacity() * sizeof(uint32_t);
+
+        // Per-type counters
+        total_size += type_counts.size() * (sizeof(std::type_index) + sizeof(size_t));
 
         // Free indices vector
-        total_size += sizeof(std::vector<size_t>) + (free_indices.capacity() * sizeof(size_t));
+        total_size += free_indices.capacity() * sizeof(size_t);
 
-        // Actual stored objects
-        for (const auto& item : data) {
-            if (item.has_value()) {
-                auto sized_obj = std::any_cast<std::shared_ptr<ISizedObject>>(item);
-                total_size += sized_obj->size() + sizeof(std::shared_ptr<ISizedObject>);
-            }
-        }
+        // Boxed objects on the heap
+        total_size += heap_bytes;
 
         return total_size;
     }
 
-    void remove(size_t index) {
-        if (index >= data.size() || !data[index].has_value()) {
-            throw InvalidIndexException(index);
-        }
-
-        const std::type_info& type = data[index].type();
-        auto type_index = std::type_index(type);
-
-        // Clear the data at the index
-        data[index].reset();
-
-        // Remove the index from type_indices
-        auto& indices = type_indices[type_index];
-        indices.erase(std::remove(indices.begin(), indices.end(), index), indices.end());
+    void remove(Handle handle) {
+        size_t index = checked_slot(handle).dense;
+        Box& box = data[index];
 
-        // If the type no longer has any indices, remove it from type_indices
-        if (indices.empty()) {
-            type_indices.erase(type_index);
+        auto type_index = std::type_index(*box.type);
+        if (--type_counts[type_index] == 0) {
+            type_counts.erase(type_index);
         }
 
-        // Add to free_indices
+        // Clear the data at the index and retire the slot
+        heap_bytes -= box.heap_bytes();
+        box.reset();
+        data_slot[index] = EmptySlot;
         free_indices.push_back(index);
 
+        Slot& slot = slots[handle.index];
+        slot.dense = EmptySlot;
+        bump_generation(slot.generation);
+        free_slots.push_back(handle.index);
+
         shrink(ShrinkPolicy{});
     }
 
@@ -161,44 +343,253 @@ private:
     }
 
     void shrink(Shrinkable) {
-        if (free_indices.empty()) return;
+        // Compact once holes make up half of the data, so the O(n) pass is
+        // amortized over at least n/2 removals
+        if (free_indices.empty() || free_indices.size() * 2 < data.size()) return;
 
-        // Always compact if there are free indices
         compact();
 
-        // Shrink to fit the data vector
         data.shrink_to_fit();
-
-        // Shrink to fit all vectors in type_indices
-        for (auto& [_, indices] : type_indices) {
-            indices.shrink_to_fit();
-        }
-
-        // Shrink to fit free_indices
+        data_slot.shrink_to_fit();
         free_indices.shrink_to_fit();
     }
 
-
+    // Move every live element down once and patch the slot that owns it
     void compact() {
         size_t write = 0;
         for (size_t read = 0; read < data.size(); ++read) {
             if (data[read].has_value()) {
                 if (write != read) {
                     data[write] = std::move(data[read]);
-                    // Update type_indices
-                    for (auto& [_, indices] : type_indices) {
-                        std::replace(indices.begin(), indices.end(), read, write);
-                    }
+                    data_slot[write] = data_slot[read];
+                    slots[data_slot[write]].dense = static_cast<uint32_t>(write);
                 }
                 ++write;
             }
         }
         data.resize(write);
+        data_slot.resize(write);
         free_indices.clear();
     }
 
 };
 
+// Dense id for every stored type, used to index the columns of ColumnStorage
+inline uint32_t next_type_slot() {
+    static std::atomic<uint32_t> next{ 0 };
+    return next++;
+}
+
+template<typename T>
+uint32_t type_slot() {
+    static const uint32_t slot = next_type_slot();
+    return slot;
+}
+
+// Column layout: values of each type live contiguously in their own vector,
+// so get<T> is an array access and for_each<T> streams through one vector.
+// Handles stay valid across removals through a per-column generational slot
+// table, which lets remove() swap the last value into the hole and keep the
+// column packed.
+template<typename ShrinkPolicy, size_t InlineSize>
+class HeterogeneousContainer<ShrinkPolicy, ColumnStorage, InlineSize> {
+public:
+    struct Handle {
+        uint32_t type = 0;  // type slot, see type_slot<T>()
+        uint32_t index = 0; // slot inside that type's column
+        uint32_t generation = 0;
+    };
+
+private:
+
+    struct IColumn {
+        virtual ~IColumn() = default;
+        virtual bool contains(uint32_t slot, uint32_t generation) const = 0;
+        virtual void remove(uint32_t slot) = 0;
+        virtual void shrink_if_sparse() = 0;
+        virtual size_t size() const = 0;
+        virtual size_t size_bytes() const = 0;
+        virtual const char* type_name() const = 0;
+    };
+
+    template<typename T>
+    struct Column : IColumn {
+        std::vector<T> values;            // packed values
+        std::vector<uint32_t> dense_slot; // slot of values[i]
+        std::vector<uint32_t> slot_dense; // position of each slot in values, EmptySlot if free
+        std::vector<uint32_t> slot_generation;
+        std::vector<uint32_t> free_slots;
+
+        template<typename U>
+        uint32_t insert(U&& value) {
+            // Reserve the bookkeeping first and add the value last of the
+            // throwing steps, so any failure leaves the column unchanged
+            reserve_one_more(dense_slot);
+            if (free_slots.empty()) {
+                reserve_one_more(slot_dense);
+                reserve_one_more(slot_generation);
+            }
+            values.push_back(std::forward<U>(value));
+            uint32_t slot;
+            if (!free_slots.empty()) {
+                slot = free_slots.back();
+                free_slots.pop_back();
+            }
+            else {
+                slot = static_cast<uint32_t>(slot_dense.size());
+                slot_dense.push_back(EmptySlot);
+                slot_generation.push_back(FirstGeneration);
+            }
+            slot_dense[slot] = static_cast<uint32_t>(values.size() - 1);
+            dense_slot.push_back(slot);
+            return slot;
+        }
+
+        bool contains(uint32_t slot, uint32_t generation) const override {
+            return slot < slot_dense.size() && slot_dense[slot] != EmptySlot && slot_generation[slot] == generation;
+        }
+
+        void remove(uint32_t slot) override {
+            uint32_t dense = slot_dense[slot];
+            uint32_t last = static_cast<uint32_t>(values.size() - 1);
+            if (dense != last) {
+                values[dense] = std::move(values[last]);
+                dense_slot[dense] = dense_slot[last];
+                slot_dense[dense_slot[dense]] = dense;
+            }
+            values.pop_back();
+            dense_slot.pop_back();
+            slot_dense[slot] = EmptySlot;
+            bump_generation(slot_generation[slot]);
+            free_slots.push_back(slot);
+        }
+
+        // Release memory once the column uses under a quarter of its
+        // capacity, so the reallocation is amortized over many removals
+        void shrink_if_sparse() override {
+            if (values.size() < values.capacity() / 4) {
+                values.shrink_to_fit();
+                dense_slot.shrink_to_fit();
+            }
+        }
+
+        size_t size() const override {
+            return values.size();
+        }
+
+        size_t size_bytes() const override {
+            return sizeof(*this) + values.capacity() * sizeof(T) +
+                (dense_slot.capacity() + slot_dense.capacity() + slot_generation.capacity() + free_slots.capacity()) * sizeof(uint32_t);
+        }
+
+        const char* type_name() const override {
+            return typeid(T).name();
+        }
+    };
+
+    std::vector<std::unique_ptr<IColumn>> columns; // indexed by type slot
+
+    template<typename T>
+    Column<T>* column() const {
+        uint32_t slot = type_slot<T>();
+        return slot < columns.size() ? static_cast<Column<T>*>(columns[slot].get()) : nullptr;
+    }
+
+    IColumn& checked_column(const Handle& handle) const {
+        if (handle.type >= columns.size() || !columns[handle.type]) {
+            throw InvalidTypeSlotException(handle.type);
+        }
+        if (!columns[handle.type]->contains(handle.index, handle.generation)) {
+            throw StaleHandleException(handle.index, handle.generation);
+        }
+        return *columns[handle.type];
+    }
+
+public:
+
+    template<typename T>
+    Handle insert(T&& value) {
+        using U = std::decay_t<T>;
+        uint32_t slot = type_slot<U>();
+        if (slot >= columns.size()) {
+            columns.resize(slot + 1);
+        }
+        if (!columns[slot]) {
+            columns[slot] = std::make_unique<Column<U>>();
+        }
+        auto* typed = static_cast<Column<U>*>(columns[slot].get());
+        uint32_t index = typed->insert(std::forward<T>(value));
+        return Handle{ slot, index, typed->slot_generation[index] };
+    }
+
+    template<typename T>
+    T& get(Handle handle) {
+        IColumn& base = checked_column(handle);
+        if (handle.type != type_slot<T>()) {
+            throw TypeMismatchException(typeid(T).name(), base.type_name());
+        }
+        auto& typed = static_cast<Column<T>&>(base);
+        return typed.values[typed.slot_dense[handle.index]];
+    }
+
+    template<typename T>
+    const T& get(Handle handle) const {
+        return const_cast<HeterogeneousContainer*>(this)->template get<T>(handle);
+    }
+
+    // Visit every value of type T, in storage order
+    template<typename T, typename Func>
+    void for_each(Func&& func) {
+        if (Column<T>* typed = column<T>()) {
+            for (T& value : typed->values) {
+                func(value);
+            }
+        }
+    }
+
+    template<typename T, typename Func>
+    void for_each(Func&& func) const {
+        if (const Column<T>* typed = column<T>()) {
+            for (const T& value : typed->values) {
+                func(value);
+            }
+        }
+    }
+
+    // Number of stored values of type T
+    template<typename T>
+    size_t count() const {
+        const Column<T>* typed = column<T>();
+        return typed ? typed->size() : 0;
+    }
+
+    size_t size_bytes() const {
+        size_t total_size = sizeof(*this) + columns.capacity() * sizeof(std::unique_ptr<IColumn>);
+        for (const auto& col : columns) {
+            if (col) {
+                total_size += col->size_bytes();
+            }
+        }
+        return total_size;
+    }
+
+    void remove(Handle handle) {
+        checked_column(handle).remove(handle.index);
+        shrink(ShrinkPolicy{}, *columns[handle.type]);
+    }
+
+private:
+
+    void shrink(NonShrinkable, IColumn&) {
+        // Do nothing for non-shrinkable container
+    }
+
+    void shrink(Shrinkable, IColumn& col) {
+        col.shrink_if_sparse();
+    }
+
+};
+
 struct Point {
     int x, y;
     Point(int x, int y) : x(x), y(y) {}
@@ -212,10 +603,12 @@ int main() {
         auto index1 = shrinkable_container.insert(42);
         auto index2 = shrinkable_container.insert(3.14);
         auto index3 = shrinkable_container.insert(Point{ 1, 2 });
+        auto index_text = shrinkable_container.insert(std::string("too large to store inline"));
 
         std::cout << "Value at index1: " << shrinkable_container.get<int>(index1) << std::endl;
         std::cout << "Value at index2: " << shrinkable_container.get<double>(index2) << std::endl;
         std::cout << "Value at index3: " << shrinkable_container.get<Point>(index3).x << ", " << shrinkable_container.get<Point>(index3).y << std::endl;
+        std::cout << "Value at index_text: " << shrinkable_container.get<std::string>(index_text) << std::endl;
 
         std::cout << "Size of shrinkable_container: " << shrinkable_container.size_bytes() << " bytes\n";
 
@@ -225,8 +618,39 @@ int main() {
         std::cout << "Removing index2\n";
         shrinkable_container.remove(index2);
 
+        // A handle to a removed element is reported, even once its slot is reused
+        auto index4 = shrinkable_container.insert(7);
+        std::cout << "index1 still valid: " << (shrinkable_container.contains(index1) ? "yes" : "no") << std::endl;
+        std::cout << "Value at index4: " << shrinkable_container.get<int>(index4) << std::endl;
+        std::cout << "Value at index3 after compaction: " << shrinkable_container.get<Point>(index3).x << std::endl;
+
         std::cout << "Size of shrinkable_container: " << shrinkable_container.size_bytes() << " bytes\n";
 
+        HeterogeneousContainer<NonShrinkable, ColumnStorage> column_container;
+
+        auto handle1 = column_container.insert(42);
+        auto handle2 = column_container.insert(3.14);
+        auto handle3 = column_container.insert(Point{ 1, 2 });
+        column_container.insert(7);
+        column_container.insert(Point{ 3, 4 });
+
+        std::cout << "Column value at handle1: " << column_container.get<int>(handle1) << std::endl;
+        std::cout << "Column value at handle2: " << column_container.get<double>(handle2) << std::endl;
+        std::cout << "Column value at handle3: " << column_container.get<Point>(handle3).x << ", " << column_container.get<Point>(handle3).y << std::endl;
+
+        int sum = 0;
+        column_container.for_each<int>([&sum](int value) { sum += value; });
+        std::cout << "Sum of ints: " << sum << std::endl;
+
+        std::cout << "Removing handle3\n";
+        column_container.remove(handle3);
+        std::cout << "Points left: " << column_container.count<Point>() << std::endl;
+
+        std::cout << "Size of column_container: " << column_container.size_bytes() << " bytes\n";
+
+        // Asking for the wrong type is reported, not reinterpreted
+        column_container.get<double>(handle1);
+
     }
     catch (const ContainerException& ex) {
         std::cerr << "Exception: " << ex.what() << std::endl;